@@ -1,40 +1,78 @@
 #include "LINAnalyzer.h"
 #include "LINAnalyzerSettings.h"
 #include <AnalyzerChannelData.h>
-#include <math.h>
-#include <map>
+#include <chrono>
 namespace
 {
-    std::map<LINAnalyzerResults::tLINFrameState, std::string> FrameTypeStringLookup = {
-        { LINAnalyzerResults::NoFrame, "no_frame" },          { LINAnalyzerResults::headerBreak, "header_break" },
-        { LINAnalyzerResults::headerSync, "header_sync" },    { LINAnalyzerResults::headerPID, "header_pid" },
-        { LINAnalyzerResults::responseDataZero, "data" },     { LINAnalyzerResults::responseData, "data" },
-        { LINAnalyzerResults::responseChecksum, "checksum" }, { LINAnalyzerResults::responsePotentialChecksum, "data_or_checksum" },
+    // FrameV2 type names, indexed by LINDecoder::tLINFrameState.
+    const char* const FrameTypeNames[] = {
+        "no_frame", "header_break", "header_sync", "header_pid", "data", "data", "checksum",
     };
+    static_assert( sizeof( FrameTypeNames ) / sizeof( FrameTypeNames[ 0 ] ) == LINDecoder::responseChecksum + 1,
+                   "every frame state needs a FrameV2 type name" );
+
+    // FrameV2 flag keys, indexed by bit position in LINDecoder::tLINFrameFlags.
+    const char* const FrameFlagNames[] = {
+        "byte_framing_error",
+        "header_break_expected",
+        "header_sync_expected",
+        "checksum_mismatch",
+        "pid_parity_error",
+    };
+    const U32 FrameFlagCount = sizeof( FrameFlagNames ) / sizeof( FrameFlagNames[ 0 ] );
 
-    std::string FrameTypeToString( LINAnalyzerResults::tLINFrameState state )
-    {
-        return FrameTypeStringLookup.at( state );
-    }
+    // indexed by LINDecoder::tLINMarker.
+    const AnalyzerResults::MarkerType MarkerTypes[] = {
+        AnalyzerResults::Start, AnalyzerResults::Stop,     AnalyzerResults::One,
+        AnalyzerResults::Zero,  AnalyzerResults::ErrorDot, AnalyzerResults::ErrorSquare,
+    };
+    static_assert( sizeof( MarkerTypes ) / sizeof( MarkerTypes[ 0 ] ) == LINDecoder::MarkerCount, "every marker needs a type" );
 
-    std::vector<std::string> FrameFlagsToString( U8 flags )
+    // the input channel, as the decoder reads it.
+    class ChannelEdgeSource : public LINEdgeSource
     {
-        std::vector<std::string> strings;
-        if( flags & LINAnalyzerResults::byteFramingError )
-            strings.push_back( "byte_framing_error" );
-        if( flags & LINAnalyzerResults::headerBreakExpected )
-            strings.push_back( "header_break_expected" );
-        if( flags & LINAnalyzerResults::headerSyncExpected )
-            strings.push_back( "header_sync_expected" );
-        if( flags & LINAnalyzerResults::checksumMismatch )
-            strings.push_back( "checksum_mismatch" );
-
-        return strings;
-    }
+      public:
+        explicit ChannelEdgeSource( AnalyzerChannelData* channel ) : mChannel( channel )
+        {
+        }
+
+        virtual U64 GetSampleNumber()
+        {
+            return mChannel->GetSampleNumber();
+        }
+
+        virtual bool IsHigh()
+        {
+            return mChannel->GetBitState() == BIT_HIGH;
+        }
+
+        virtual void AdvanceToNextEdge()
+        {
+            mChannel->AdvanceToNextEdge();
+        }
+
+        virtual void AdvanceToAbsPosition( U64 sample_number )
+        {
+            mChannel->AdvanceToAbsPosition( sample_number );
+        }
+
+        virtual U64 GetSampleOfNextEdge()
+        {
+            return mChannel->GetSampleOfNextEdge();
+        }
+
+        virtual bool WouldAdvancingToAbsPositionCauseTransition( U64 sample_number )
+        {
+            return mChannel->WouldAdvancingToAbsPositionCauseTransition( sample_number );
+        }
+
+      private:
+        AnalyzerChannelData* mChannel;
+    };
 }
 
 LINAnalyzer::LINAnalyzer()
-    : Analyzer2(), mSettings( new LINAnalyzerSettings() ), mSimulationInitilized( false ), mFrameState( LINAnalyzerResults::NoFrame )
+    : Analyzer2(), mSettings( new LINAnalyzerSettings() ), mSimulationInitilized( false )
 {
     SetAnalyzerSettings( mSettings.get() );
     UseFrameV2();
@@ -47,209 +85,238 @@ LINAnalyzer::~LINAnalyzer()
 
 void LINAnalyzer::WorkerThread()
 {
-    mFrameState = LINAnalyzerResults::NoFrame; // reset every time we run.
-    bool showIBS = false;                      // show inter-byte space?
-    U8 nDataBytes = 0;
-    bool byteFramingError;
-    Frame byteFrame; // byte fame from start bit to stop bit
-    Frame ibsFrame;  // inter-byte space startsing after SYNC
-    bool is_data_really_break;
-    bool ready_to_save = false;
-    bool is_start_of_packet = false;
-
-    ibsFrame.mData1 = 0;
-    ibsFrame.mData2 = 0;
-    ibsFrame.mFlags = 0;
-    ibsFrame.mType = 0;
-
     mSerial = GetAnalyzerChannelData( mSettings->mInputChannel );
+    ChannelEdgeSource source( mSerial );
+
+    LINDecoder::Settings settings;
+    settings.mSampleRate = GetSampleRate();
+    settings.mBitRate = mSettings->mBitRate;
+    settings.mLINVersion = mSettings->mLINVersion;
+    settings.mDescriptionFile = mSettings->mDescriptionFile;
+    // error markers are always drawn; decide once which of the others are wanted.
+    settings.mMarkBits = mSettings->mMarkerDensity == LINAnalyzerSettings::AllMarkers;
+    settings.mMarkStartStop = mSettings->mMarkerDensity != LINAnalyzerSettings::ErrorMarkersOnly;
+
+    mUncommittedFrames = 0;
+    mLastCommitSample = 0;
+    mCommitIntervalSamples = U64( GetSampleRate() ) * mSettings->mCommitIntervalMs / 1000;
 
-    if( mSerial->GetBitState() == BIT_LOW )
-        mSerial->AdvanceToNextEdge();
+    mDecoder.Start( &source, this, settings );
+
+#if LIN_ANALYZER_STATS
+    mStatsFields = 0;
+#endif
 
     mResults->CancelPacketAndStartNewPacket();
 
     for( ;; )
     {
-        is_data_really_break = false;
-        is_start_of_packet = false;
+#if LIN_ANALYZER_STATS
+        const U32 field_state = mDecoder.GetFrameState();
+        const bool time_field = mDecoder.GetStats().TimeThisField();
+        std::chrono::steady_clock::time_point field_start;
+        if( time_field )
+            field_start = std::chrono::steady_clock::now();
+#endif
+
+        // whatever the policy, don't sit on results while we wait for more data to arrive.
+        if( mUncommittedFrames != 0 && !mSerial->DoMoreTransitionsExistInCurrentData() )
+            CommitResults( mSerial->GetSampleNumber() );
+
+        mDecoder.DecodeField();
+
+        if( CommitDue() )
+            CommitResults( mField.mEndingSample );
+
+#if LIN_ANALYZER_STATS
+        if( time_field )
+            mDecoder.GetStats().mStateSeconds[ field_state ] +=
+                LINAnalyzerStats::TimingInterval * std::chrono::duration<double>( std::chrono::steady_clock::now() - field_start ).count();
+#endif
+    }
+}
 
-        ibsFrame.mStartingSampleInclusive = mSerial->GetSampleNumber();
-        if( ( mFrameState == LINAnalyzerResults::NoFrame ) || ( mFrameState == LINAnalyzerResults::headerBreak ) )
-        {
-            byteFrame.mData1 = GetBreakField( byteFrame.mStartingSampleInclusive, byteFrame.mEndingSampleInclusive, byteFramingError );
-        }
-        else
-        {
-            byteFrame.mData1 =
-                ByteFrame( byteFrame.mStartingSampleInclusive, byteFrame.mEndingSampleInclusive, byteFramingError, is_data_really_break );
-        }
+void LINAnalyzer::OnMarker( U64 sample, LINDecoder::tLINMarker marker )
+{
+    mResults->AddMarker( sample, MarkerTypes[ marker ], mSettings->mInputChannel );
+}
 
-        ibsFrame.mEndingSampleInclusive = byteFrame.mStartingSampleInclusive;
-        byteFrame.mData2 = 0;
-        byteFrame.mFlags = byteFramingError ? LINAnalyzerResults::byteFramingError : 0;
-        byteFrame.mType = mFrameState;
+void LINAnalyzer::OnInterByteSpace( S64 starting_sample, S64 ending_sample )
+{
+    Frame ibs_frame;
+    ibs_frame.mStartingSampleInclusive = starting_sample;
+    ibs_frame.mEndingSampleInclusive = ending_sample;
+    ibs_frame.mData1 = 0;
+    ibs_frame.mData2 = 0;
+    ibs_frame.mFlags = 0;
+    ibs_frame.mType = 0;
+
+    mResults->AddFrame( ibs_frame );
+    LIN_STATS( mDecoder.GetStats().Count( LINAnalyzerStats::Frames ) );
+    ++mUncommittedFrames;
+}
 
+void LINAnalyzer::OnField( const LINDecoder::Field& field )
+{
+    Frame byte_frame;
+    byte_frame.mStartingSampleInclusive = field.mStartingSample;
+    byte_frame.mEndingSampleInclusive = field.mEndingSample;
+    byte_frame.mData1 = field.mData;
+    byte_frame.mData2 = field.mDataBytes;
+    byte_frame.mFlags = field.mFlags;
+    byte_frame.mType = field.mType;
+
+    if( field.mStartsPacket )
+        mResults->CommitPacketAndStartNewPacket(); // there is no harm in calling this more than once when no frames are commited.
+
+    mResults->AddFrame( byte_frame );
+    LIN_STATS( mDecoder.GetStats().Count( LINAnalyzerStats::Frames ) );
+    if( mSettings->mFrameOutput == LINAnalyzerSettings::ByteFrameOutput )
+        AddByteFrameV2( byte_frame );
+
+    if( field.mEndsPacket )
+        mResults->CommitPacketAndStartNewPacket();
+    ++mUncommittedFrames;
+    mField = field;
+}
 
-        if( is_data_really_break )
-        {
-            // here we reset.
-            mFrameState = LINAnalyzerResults::NoFrame;
-            showIBS = false;
-        }
+void LINAnalyzer::OnLINFrame( const LINDecoder::LINFrame& lin_frame )
+{
+    if( mSettings->mFrameOutput == LINAnalyzerSettings::LINFrameOutput )
+        AddLINFrameV2( lin_frame );
+}
 
-        if( showIBS )
-        {
-            mResults->AddFrame( ibsFrame );
-            // FrameV2 frame_v2_ibs;
-            // mResults->AddFrameV2( frame_v2_ibs, "InterByteSpace", ibsFrame.mStartingSampleInclusive, ibsFrame.mEndingSampleInclusive );
-        }
-        ready_to_save = false;
+// after each field, whether the commit policy wants the results so far committed.
+bool LINAnalyzer::CommitDue() const
+{
+    switch( mSettings->mCommitPolicy )
+    {
+    case LINAnalyzerSettings::CommitLowLatency:
+        return ( mField.mType == LINDecoder::headerPID ) || mField.mStartsPacket || mField.mEndsPacket ||
+               ( mDecoder.GetFrameState() == LINDecoder::NoFrame );
+    case LINAnalyzerSettings::CommitPerPacket:
+        return mField.mStartsPacket || mField.mEndsPacket;
+    case LINAnalyzerSettings::CommitBatched:
+        return ( mUncommittedFrames >= mSettings->mCommitFrames ) ||
+               ( U64( mField.mEndingSample ) - mLastCommitSample >= mCommitIntervalSamples );
+    }
+    return false;
+}
 
-        switch( mFrameState )
-        {
-        case LINAnalyzerResults::NoFrame:
-            mFrameState = LINAnalyzerResults::headerBreak;
-        case LINAnalyzerResults::headerBreak: // expecting break
-            showIBS = true;
-            if( byteFrame.mData1 == 0x00 )
-            {
-                mFrameState = LINAnalyzerResults::headerSync;
-                byteFrame.mType = LINAnalyzerResults::headerBreak;
-                is_start_of_packet = true;
-            }
-            else
-            {
-                byteFrame.mFlags |= LINAnalyzerResults::headerBreakExpected;
-                mFrameState = LINAnalyzerResults::NoFrame;
-            }
-            break;
-        case LINAnalyzerResults::headerSync: // expecting sync.
-            if( byteFrame.mData1 == 0x55 )
-            {
-                mFrameState = LINAnalyzerResults::headerPID;
-            }
-            else
-            {
-                byteFrame.mFlags |= LINAnalyzerResults::headerSyncExpected;
-                mFrameState = LINAnalyzerResults::NoFrame;
-            }
-            break;
-        case LINAnalyzerResults::headerPID: // expecting PID.
-        {
-            mFrameState = LINAnalyzerResults::responseDataZero;
-
-            bool classic_identifier = false;
-            U8 identifier = byteFrame.mData1 & 0x3F;
-            if( identifier == 0x3C || identifier == 0x3D )
-                classic_identifier = true;
-
-            mChecksum.clear();
-            if( mSettings->mLINVersion >= 2 && classic_identifier == false )
-            {
-                mChecksum.add( byteFrame.mData1 ); // We only add the PID byte to the checksum IF we're using version 2 AND we're not using
-                                                   // one of the classic identifers.
-            }
-        }
+void LINAnalyzer::AddByteFrameV2( const Frame& byte_frame )
+{
+    FrameV2 frame_v2;
+    switch( static_cast<LINDecoder::tLINFrameState>( byte_frame.mType ) )
+    {
+    case LINDecoder::headerPID:
+        frame_v2.AddInteger( "protected_id", byte_frame.mData1 & 0x3F );
         break;
-        // LIN Response
-        case LINAnalyzerResults::responseDataZero: // expecting first resppnse data byte.
-            if( mSettings->mLINVersion < 2 )
-            {
-                mChecksum.clear();
-            }
-            mChecksum.add( byteFrame.mData1 );
-            nDataBytes = 1;
-            mFrameState = LINAnalyzerResults::responseData;
-            break;
-        case LINAnalyzerResults::responseData: // expecting response data.
-            if( nDataBytes >= 8 || mChecksum.result() == byteFrame.mData1 )
-            {
-                // FIXME - peek ahead for BREAK such that checksum match + BREAK detected at next char == end of packet.
-                mFrameState = LINAnalyzerResults::responseChecksum;
-                byteFrame.mType = LINAnalyzerResults::responseChecksum;
-                // note, there is no break here. it rolls into the checksum state.
-
-                if( nDataBytes >= 8 )
-                    ready_to_save = true; // we should not terminate a packet unless we're sure that the packet is over, and we're not sure
-                                          // yet, except when there are 8 data bytes.
-                else
-                    byteFrame.mType = LINAnalyzerResults::responsePotentialChecksum;
-            }
-            else
-            {
-                ++nDataBytes;
-                mChecksum.add( byteFrame.mData1 );
-                break;
-            }
-        case LINAnalyzerResults::responseChecksum: // expecting checksum.
-
-            if( mChecksum.result() != byteFrame.mData1 )
-            {
-                byteFrame.mFlags |= LINAnalyzerResults::checksumMismatch;
-            }
-            if( ready_to_save == true )
-            {
-                mFrameState = LINAnalyzerResults::NoFrame;
-                showIBS = false;
-                nDataBytes = 0;
-            }
-            else
-            {
-                mFrameState = LINAnalyzerResults::responseData;
-                mChecksum.add( byteFrame.mData1 );
-                ++nDataBytes;
-            }
-
-
-            break;
-        }
+    case LINDecoder::responseDataZero: // expecting first response data byte.
+    case LINDecoder::responseData:     // expecting response data.
+        frame_v2.AddInteger( "data", byte_frame.mData1 );
+        frame_v2.AddInteger( "index", byte_frame.mData2 - 1 );
+        break;
+    case LINDecoder::responseChecksum: // expecting checksum.
+        frame_v2.AddInteger( "checksum", byte_frame.mData1 );
+        break;
+    default:
+        break;
+    }
+    for( U32 flag = 0; flag < FrameFlagCount; flag++ )
+    {
+        if( byte_frame.mFlags & ( 1 << flag ) )
+            frame_v2.AddBoolean( FrameFlagNames[ flag ], true );
+    }
+    mResults->AddFrameV2( frame_v2, FrameTypeNames[ byte_frame.mType ], byte_frame.mStartingSampleInclusive,
+                          byte_frame.mEndingSampleInclusive );
+}
 
-        byteFrame.mData2 = nDataBytes;
+void LINAnalyzer::AddLINFrameV2( const LINDecoder::LINFrame& lin_frame )
+{
+    FrameV2 frame_v2;
+    double sample_rate = GetSampleRate();
 
-        if( is_start_of_packet )
-            mResults->CommitPacketAndStartNewPacket(); // there is no harm in calling this more than once when no frames are commited.
+    if( lin_frame.mHasPID )
+    {
+        U8 identifier = lin_frame.mPID & 0x3F;
+        frame_v2.AddInteger( "id", identifier );
+        frame_v2.AddInteger( "parity", lin_frame.mPID >> 6 );
+
+        const LINDescriptionFile& description = mDecoder.GetDescription();
+        const LINDescriptionFile::FrameInfo* frame_info = description.GetFrame( identifier );
+        const char* publisher = frame_info != NULL ? description.GetNodeName( frame_info->mPublisher ) : NULL;
+        if( publisher != NULL )
+            frame_v2.AddString( "publisher", publisher );
+    }
 
+    frame_v2.AddDouble( "header_duration", ( lin_frame.mHeaderEndingSample - lin_frame.mStartingSample ) / sample_rate );
 
-        mResults->AddFrame( byteFrame );
-        FrameV2 frame_v2;
-        switch( static_cast<LINAnalyzerResults::tLINFrameState>( byteFrame.mType ) )
-        {
-        case LINAnalyzerResults::headerPID:
-            frame_v2.AddInteger( "protected_id", byteFrame.mData1 & 0x3F );
-            break;
-        case LINAnalyzerResults::responseDataZero: // expecting first response data byte.
-        case LINAnalyzerResults::responseData:     // expecting response data.
-            frame_v2.AddInteger( "data", byteFrame.mData1 );
-            frame_v2.AddInteger( "index", byteFrame.mData2 - 1 );
-            break;
-        case LINAnalyzerResults::responseChecksum: // expecting checksum.
-            frame_v2.AddInteger( "checksum", byteFrame.mData1 );
-            break;
-        case LINAnalyzerResults::responsePotentialChecksum:
-            // TODO: handle "Possible checksum" case!
-            // I think LIN 2.0 explicitly specifies the message length based on the ID, removing any ambiguity.
-            // for now, assume it's the checksum. We have already validated that the byte value is a valid checksum.
-            frame_v2.AddInteger( "checksum", byteFrame.mData1 );
-            frame_v2.AddInteger( "data", byteFrame.mData1 );
-            frame_v2.AddInteger( "index", byteFrame.mData2 - 1 );
-            break;
-        default:
-            break;
-        }
-        auto flag_strings = FrameFlagsToString( byteFrame.mFlags );
-        for( const auto& flag_string : flag_strings )
-        {
-            frame_v2.AddBoolean( flag_string.c_str(), true );
-        }
-        mResults->AddFrameV2( frame_v2, FrameTypeToString( static_cast<LINAnalyzerResults::tLINFrameState>( byteFrame.mType ) ).c_str(),
-                              byteFrame.mStartingSampleInclusive, byteFrame.mEndingSampleInclusive );
+    // the last byte of the response is the checksum; everything before it is data.
+    if( lin_frame.mResponseLength > 0 )
+    {
+        U8 data_length = lin_frame.mResponseLength - 1;
+        frame_v2.AddByteArray( "data", lin_frame.mResponse, data_length );
+        frame_v2.AddInteger( "checksum", lin_frame.mResponse[ data_length ] );
+        frame_v2.AddString( "checksum_model", lin_frame.mEnhancedChecksum ? "enhanced" : "classic" );
+        frame_v2.AddDouble( "response_space", ( lin_frame.mResponseStartingSample - lin_frame.mHeaderEndingSample ) / sample_rate );
+        frame_v2.AddDouble( "response_duration", ( lin_frame.mEndingSample - lin_frame.mResponseStartingSample ) / sample_rate );
+    }
 
-        if( ready_to_save )
-            mResults->CommitPacketAndStartNewPacket();
-        mResults->CommitResults();
-        ReportProgress( byteFrame.mEndingSampleInclusive );
+    for( U32 flag = 0; flag < FrameFlagCount; flag++ )
+    {
+        if( lin_frame.mFlags & ( 1 << flag ) )
+            frame_v2.AddBoolean( FrameFlagNames[ flag ], true );
     }
+    mResults->AddFrameV2( frame_v2, "lin_frame", lin_frame.mStartingSample, lin_frame.mEndingSample );
+}
+
+bool LINAnalyzer::UsesEnhancedChecksum( U8 identifier ) const
+{
+    return mDecoder.UsesEnhancedChecksum( identifier );
+}
+
+#if LIN_ANALYZER_STATS
+const LINAnalyzerStats& LINAnalyzer::GetStats() const
+{
+    return mDecoder.GetStats();
+}
+
+// totals for the run so far, as a zero width record at the sample the decoder had reached. Nothing is added if no field was
+// read since the previous record.
+void LINAnalyzer::AddStatsFrameV2( U64 sample )
+{
+    const LINAnalyzerStats& stats = mDecoder.GetStats();
+    if( stats.mCounters[ LINAnalyzerStats::Fields ] == mStatsFields )
+        return;
+
+    FrameV2 frame_v2;
+    for( U32 counter = 0; counter < LINAnalyzerStats::CounterCount; counter++ )
+    {
+        LINAnalyzerStats::tLINCounter id = static_cast<LINAnalyzerStats::tLINCounter>( counter );
+        frame_v2.AddInteger( LINAnalyzerStats::GetCounterName( id ), stats.mCounters[ counter ] );
+    }
+    for( U32 state = 0; state < LINAnalyzerStats::StateCount; state++ )
+        frame_v2.AddDouble( LINAnalyzerStats::GetStateTimeName( state ), stats.mStateSeconds[ state ] );
+    frame_v2.AddDouble( "run_time", std::chrono::duration<double>( std::chrono::steady_clock::now() - stats.mRunStart ).count() );
+
+    mResults->AddFrameV2( frame_v2, "lin_stats", sample, sample );
+    mStatsFields = stats.mCounters[ LINAnalyzerStats::Fields ];
+}
+#endif
+
+void LINAnalyzer::CommitResults( U64 sample )
+{
+#if LIN_ANALYZER_STATS
+    // caught up with the capture: publish the totals so far. Everything is committed by the end of a capture, so the last
+    // record holds the totals for the whole run.
+    mDecoder.GetStats().Count( LINAnalyzerStats::Commits );
+    if( !mSerial->DoMoreTransitionsExistInCurrentData() )
+        AddStatsFrameV2( sample );
+#endif
+    mResults->CommitResults();
+    ReportProgress( sample );
+    mUncommittedFrames = 0;
+    mLastCommitSample = sample;
 }
 
 bool LINAnalyzer::NeedsRerun()
@@ -300,163 +367,3 @@ void DestroyAnalyzer( Analyzer* analyzer )
 {
     delete analyzer;
 }
-
-double LINAnalyzer::SamplesPerBit()
-{
-    return ( double )GetSampleRate() / ( double )mSettings->mBitRate;
-}
-
-double LINAnalyzer::HalfSamplesPerBit()
-{
-    return SamplesPerBit() * 0.5;
-}
-
-void LINAnalyzer::Advance( U16 nBits )
-{
-    mSerial->Advance( nBits * SamplesPerBit() );
-}
-
-void LINAnalyzer::AdvanceHalfBit()
-{
-    mSerial->Advance( HalfSamplesPerBit() );
-}
-
-U8 LINAnalyzer::GetBreakField( S64& startingSample, S64& endingSample, bool& framingError )
-{
-    // locate the start bit (falling edge expected)...
-    U32 min_break_field_low_bits =
-        13; // as per the spec of LIN. at least 13 bits at master speed, but receiver only needs it to be 11 or more.
-    U32 num_break_bits = 0;
-    bool valid_fame = false;
-    for( ;; )
-    {
-        mSerial->AdvanceToNextEdge();
-        if( mSerial->GetBitState() == BIT_HIGH )
-        {
-            mSerial->AdvanceToNextEdge();
-        }
-        num_break_bits = round( double( mSerial->GetSampleOfNextEdge() - mSerial->GetSampleNumber() ) / SamplesPerBit() );
-        if( num_break_bits >= min_break_field_low_bits )
-        {
-            startingSample = mSerial->GetSampleNumber();
-            valid_fame = true;
-            break;
-        }
-    }
-
-    // AdvanceHalfBit( );
-    // mResults->AddMarker( mSerial->GetSampleNumber( ), AnalyzerResults::Start, mSettings->mInputChannel );
-
-    for( U32 i = 0; i < num_break_bits; i++ )
-    {
-        if( i == 0 )
-            AdvanceHalfBit();
-        else
-            Advance( 1 );
-        // let's put a dot exactly where we sample this bit:
-        mResults->AddMarker( mSerial->GetSampleNumber(), mSerial->GetBitState() == BIT_HIGH ? AnalyzerResults::One : AnalyzerResults::Zero,
-                             mSettings->mInputChannel );
-    }
-
-    // Validate the stop bit...
-    Advance( 1 );
-    if( mSerial->GetBitState() == BIT_HIGH )
-    {
-        mResults->AddMarker( mSerial->GetSampleNumber(), AnalyzerResults::Stop, mSettings->mInputChannel );
-        framingError = false;
-    }
-    else
-    {
-        mResults->AddMarker( mSerial->GetSampleNumber(), AnalyzerResults::ErrorSquare, mSettings->mInputChannel );
-        framingError = true;
-    }
-
-    endingSample = mSerial->GetSampleNumber();
-
-    return ( valid_fame ) ? 0 : 1;
-}
-
-U8 LINAnalyzer::ByteFrame( S64& startingSample, S64& endingSample, bool& framingError, bool& is_break_field )
-{
-    U8 data = 0;
-    U8 mask = 1;
-
-    framingError = false;
-    is_break_field = false;
-
-    // locate the start bit (falling edge expected)...
-    mSerial->AdvanceToNextEdge();
-    if( mSerial->GetBitState() == BIT_HIGH )
-    {
-        AdvanceHalfBit();
-        mResults->AddMarker( mSerial->GetSampleNumber(), AnalyzerResults::ErrorDot, mSettings->mInputChannel );
-        mSerial->AdvanceToNextEdge();
-        // framingError = true;
-    }
-    startingSample = mSerial->GetSampleNumber();
-    AdvanceHalfBit();
-    mResults->AddMarker( mSerial->GetSampleNumber(), AnalyzerResults::Start, mSettings->mInputChannel );
-
-    // mark each data bit (LSB first)...
-    for( U32 i = 0; i < 8; i++ )
-    {
-        Advance( 1 );
-
-        if( mSerial->GetBitState() == BIT_HIGH )
-            data |= mask;
-
-        // let's put a dot exactly where we sample this bit:
-        mResults->AddMarker( mSerial->GetSampleNumber(), mSerial->GetBitState() == BIT_HIGH ? AnalyzerResults::One : AnalyzerResults::Zero,
-                             mSettings->mInputChannel );
-
-        mask = mask << 1;
-    }
-
-    // Validate the stop bit...
-    Advance( 1 );
-    if( mSerial->GetBitState() == BIT_HIGH )
-    {
-        mResults->AddMarker( mSerial->GetSampleNumber(), AnalyzerResults::Stop, mSettings->mInputChannel );
-    }
-    else
-    {
-        // check to see if we're really in a break frame...
-        // we should be dead center in the stop bit here. (10 bits in, exactly)
-        // a break frame has at least 13 bits low, however the slave is only required to measure 11 bits low.
-        // there is no maximum limit to the length of the break frame.
-
-        bool all_13_clear =
-            !( mSerial->WouldAdvancingCauseTransition( SamplesPerBit() * 3 ) ); // checks the remaining 3 bits to make sure they are high.
-
-        mSerial->AdvanceToNextEdge(); // we're high again, and at the end of the break frame!
-        // verify that we've found a stop bit.
-        bool high_bit_present = !mSerial->WouldAdvancingCauseTransition(
-            SamplesPerBit() * 0.5 ); // if there are no transitions, that means it's high in the center of the bit field, and we're good!
-
-
-        // bool high_bit_present = mSerial->WouldAdvancingCauseTransition( SamplesPerBit() * 4 );
-
-        if( all_13_clear && high_bit_present )
-        {
-            /*mResults->AddMarker( mSerial->GetSampleNumber(), mSerial->GetBitState() == BIT_HIGH ? AnalyzerResults::One :
-            AnalyzerResults::Zero, mSettings->mInputChannel ); for( U32 i = 0; i < 4; ++i )
-            {
-                Advance( 1 );
-                mResults->AddMarker( mSerial->GetSampleNumber(), mSerial->GetBitState() == BIT_HIGH ? AnalyzerResults::One :
-            AnalyzerResults::Zero, mSettings->mInputChannel );
-            }*/
-
-            endingSample = mSerial->GetSampleNumber();
-            is_break_field = true;
-            return 0x00;
-        }
-
-
-        mResults->AddMarker( mSerial->GetSampleNumber(), AnalyzerResults::ErrorSquare, mSettings->mInputChannel );
-        framingError = true;
-    }
-
-    endingSample = mSerial->GetSampleNumber();
-
-    return data;
-}
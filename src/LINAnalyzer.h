@@ -3,11 +3,14 @@
 
 #include <Analyzer.h>
 #include "LINAnalyzerResults.h"
+#include "LINAnalyzerStats.h"
 #include "LINSimulationDataGenerator.h"
-#include "LINChecksum.h"
+#include "LINDecoder.h"
 
 class LINAnalyzerSettings;
-class LINAnalyzer : public Analyzer2
+
+// runs LINDecoder on the input channel and turns what it reports into frames, markers, packets and FrameV2 records.
+class LINAnalyzer : public Analyzer2, protected LINDecoderSink
 {
   public:
     LINAnalyzer();
@@ -22,14 +25,27 @@ class LINAnalyzer : public Analyzer2
     virtual const char* GetAnalyzerName() const;
     virtual bool NeedsRerun();
 
+    bool UsesEnhancedChecksum( U8 identifier ) const;
+
+#if LIN_ANALYZER_STATS
+    const LINAnalyzerStats& GetStats() const;
+#endif
+
   protected:
-    U8 ByteFrame( S64& startingSample, S64& endingSample, bool& framingError, bool& is_break_field );
-    U8 GetBreakField( S64& startingSample, S64& endingSample, bool& framingError );
-    inline double SamplesPerBit();
-    double HalfSamplesPerBit();
+    // LINDecoderSink.
+    virtual void OnMarker( U64 sample, LINDecoder::tLINMarker marker );
+    virtual void OnInterByteSpace( S64 starting_sample, S64 ending_sample );
+    virtual void OnField( const LINDecoder::Field& field );
+    virtual void OnLINFrame( const LINDecoder::LINFrame& lin_frame );
+
+    bool CommitDue() const;
+    void CommitResults( U64 sample );
 
-    void AdvanceHalfBit();
-    void Advance( U16 nBits );
+    void AddByteFrameV2( const Frame& byte_frame );
+    void AddLINFrameV2( const LINDecoder::LINFrame& lin_frame );
+#if LIN_ANALYZER_STATS
+    void AddStatsFrameV2( U64 sample );
+#endif
 
   protected: // vars
     std::auto_ptr<LINAnalyzerSettings> mSettings;
@@ -38,8 +54,17 @@ class LINAnalyzer : public Analyzer2
 
     LINSimulationDataGenerator mSimulationDataGenerator;
     bool mSimulationInitilized;
-    LINAnalyzerResults::tLINFrameState mFrameState;
-    LINChecksum mChecksum;
+
+    LINDecoder mDecoder;
+    LINDecoder::Field mField; // the field last reported.
+
+    U64 mUncommittedFrames; // frames added since the last CommitResults().
+    U64 mLastCommitSample;
+    U64 mCommitIntervalSamples;
+
+#if LIN_ANALYZER_STATS
+    U64 mStatsFields; // fields read when the last "lin_stats" record was added.
+#endif
 };
 
 extern "C" ANALYZER_EXPORT const char* __cdecl GetAnalyzerName();
@@ -2,324 +2,691 @@
 #include <AnalyzerHelpers.h>
 #include "LINAnalyzer.h"
 #include "LINAnalyzerSettings.h"
+#include "LINFrameTableWriter.h"
+#include "LINProtectedIdentifier.h"
 #include <iostream>
 #include <fstream>
-#include <string>
+#include <future>
+#include <string.h>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // error flag text, indexed by bit position in LINDecoder::tLINFrameFlags.
+    const char* const FlagText[] = { "!FRAME", "!BREAK", "!SYNC", "!CHK", "!PARITY" };
+    const U32 FlagCount = sizeof( FlagText ) / sizeof( FlagText[ 0 ] );
+
+    // short, medium and long labels, indexed by LINDecoder::tLINFrameState. Frames with a value append it after the label.
+    const char* const FrameLabels[][ 3 ] = {
+        { "IBS", "IB Space", "Inter-Byte Space" },
+        { "BRK", "Break", "Header Break" },
+        { "SYN", "Sync", "Header Sync" },
+        { "", "PID: ", "Protected ID: " },
+        { "", "D", "Data " },
+        { "", "D", "Data " },
+        { "", "CHK: ", "Checksum: " },
+    };
+    static_assert( sizeof( FrameLabels ) / sizeof( FrameLabels[ 0 ] ) == LINDecoder::responseChecksum + 1,
+                   "every frame state needs labels" );
+
+    // copies `src` to `pos`, truncating at `end`, and returns the new end of the string.
+    char* Append( char* pos, const char* end, const char* src )
+    {
+        while( *src != 0 && pos + 1 < end )
+            *pos++ = *src++;
+        *pos = 0;
+        return pos;
+    }
+
+    // collects export output in one large block, and hands it to the stream a block at a time rather than a line at a time.
+    class ExportBuffer
+    {
+      public:
+        ExportBuffer( std::ofstream& stream ) : mStream( stream ), mBuffer( BufferSize ), mUsed( 0 )
+        {
+        }
+
+        ~ExportBuffer()
+        {
+            Flush();
+        }
+
+        void Append( const char* text, size_t length )
+        {
+            if( mUsed + length > mBuffer.size() )
+            {
+                Flush();
+                if( length > mBuffer.size() )
+                {
+                    mStream.write( text, length );
+                    return;
+                }
+            }
+            memcpy( &mBuffer[ mUsed ], text, length );
+            mUsed += length;
+        }
+
+        void Append( const char* text )
+        {
+            Append( text, strlen( text ) );
+        }
+
+        void Flush()
+        {
+            if( mUsed != 0 )
+                mStream.write( &mBuffer[ 0 ], mUsed );
+            mUsed = 0;
+        }
+
+      private:
+        enum
+        {
+            BufferSize = 1 << 20
+        };
+
+        std::ofstream& mStream;
+        std::vector<char> mBuffer;
+        size_t mUsed;
+    };
+
+    // the text export is formatted on worker threads, a chunk of packets at a time; see GenerateTextExport().
+    const U32 TextExportMaxWorkers = 16;
+    const U32 TextChunkPackets = 4096;
+
+    typedef enum
+    {
+        FieldComma, // a time and value, then a comma.
+        FieldOnly,  // a time and value.
+        LineEnd,
+    } tTextFieldType;
+
+    struct TextField
+    {
+        U64 mSample;
+        U8 mValue;
+        U8 mType; // tTextFieldType
+    };
+
+    struct TextChunk
+    {
+        std::vector<TextField> mFields; // gathered from the results.
+        std::vector<char> mText;        // the fields, formatted.
+        U64 mLastFrame;                 // for progress.
+    };
+
+    void PutLittleEndian( U8* dest, U64 value, U32 bytes )
+    {
+        for( U32 i = 0; i < bytes; i++ )
+            dest[ i ] = U8( value >> ( 8 * i ) );
+    }
+
+    // pcap with nanosecond timestamps, and the LINKTYPE_LIN pseudo-header: https://www.tcpdump.org/linktypes/LINKTYPE_LIN.html
+    const U32 PcapNanosecondMagic = 0xA1B23C4D;
+    const U32 PcapLinkTypeLIN = 212;
+    const U32 PcapLINHeaderSize = 8;
+    const U8 PcapLINFormatRevision = 1;
+    const U8 PcapLINClassicChecksum = 0;
+    const U8 PcapLINEnhancedChecksum = 1;
+    const U8 PcapLINNoSlaveResponse = 0x01; // error flags
+    const U8 PcapLINFramingError = 0x02;
+    const U8 PcapLINParityError = 0x04;
+    const U8 PcapLINChecksumError = 0x08;
+
+    // AnalyzerHelpers::GetTimeString() goes through a double and printf for every call. For the usual fixed number of decimals,
+    // the same text can be built with integer arithmetic. The formatter checks itself against GetTimeString() before it is
+    // trusted, and still defers to it for the rare times that sit close enough to a rounding tie for the double to matter.
+    class TimeFormatter
+    {
+      public:
+        TimeFormatter( U64 trigger_sample, U32 sample_rate )
+            : mTriggerSample( trigger_sample ), mSampleRate( sample_rate ), mDecimals( 0 ), mScale( 1 ), mFast( false )
+        {
+            char text[ TextSize ];
+            AnalyzerHelpers::GetTimeString( trigger_sample + 1, trigger_sample, sample_rate, text, TextSize );
+            const char* point = strchr( text, '.' );
+            if( point != NULL )
+                mDecimals = U32( strlen( point + 1 ) );
+
+            for( U32 i = 0; i < mDecimals; i++ )
+                mScale *= 10;
+
+            // the scaled remainder must fit in 64 bits.
+            if( mSampleRate == 0 || mDecimals > 18 || mScale > ( U64( 1 ) << 63 ) / mSampleRate )
+                return;
+
+            // a fixed set of probes, around whole seconds and the trigger, and scattered across a long capture.
+            mFast = true;
+            U64 probe = 0x9E3779B97F4A7C15ull;
+            for( U32 i = 0; i < 256 && mFast; i++ )
+            {
+                probe = probe * 6364136223846793005ull + 1442695040888963407ull;
+                S64 offset;
+                switch( i % 4 )
+                {
+                case 0:
+                    offset = S64( i / 4 ) - 32;
+                    break;
+                case 1:
+                    offset = S64( i / 4 ) * mSampleRate + S64( probe % 3 ) - 1;
+                    break;
+                case 2:
+                    offset = S64( probe >> 24 ) - S64( U64( 1 ) << 39 );
+                    break;
+                default:
+                    offset = S64( probe >> 8 );
+                    break;
+                }
+
+                char expected[ TextSize ];
+                AnalyzerHelpers::GetTimeString( trigger_sample + offset, trigger_sample, sample_rate, expected, TextSize );
+                if( FormatFast( trigger_sample + offset, text ) && strcmp( text, expected ) != 0 )
+                    mFast = false;
+            }
+        }
+
+        // writes the time of `sample` to `text`, which has room for TextSize characters.
+        void Format( U64 sample, char* text ) const
+        {
+            if( !mFast || !FormatFast( sample, text ) )
+                AnalyzerHelpers::GetTimeString( sample, mTriggerSample, mSampleRate, text, TextSize );
+        }
+
+        enum
+        {
+            TextSize = 128
+        };
+
+      private:
+        bool FormatFast( U64 sample, char* text ) const
+        {
+            S64 offset = S64( sample - mTriggerSample );
+            U64 magnitude = offset < 0 ? U64( 0 ) - U64( offset ) : U64( offset );
+            U64 seconds = magnitude / mSampleRate;
+            U64 scaled = ( magnitude % mSampleRate ) * mScale;
+            U64 fraction = scaled / mSampleRate;
+            U64 remainder = scaled % mSampleRate;
+
+            // the double GetTimeString() divides with is off by a few parts in 2^53; don't guess which way it rounds a near tie.
+            U64 distance = 2 * remainder > mSampleRate ? 2 * remainder - mSampleRate : mSampleRate - 2 * remainder;
+            if( double( distance ) <= double( magnitude ) * double( mScale ) * ( 1.0 / double( U64( 1 ) << 48 ) ) )
+                return false;
+
+            if( 2 * remainder > mSampleRate && ++fraction == mScale )
+            {
+                fraction = 0;
+                ++seconds;
+            }
+
+            char digits[ 24 ];
+            U32 count = 0;
+            do
+            {
+                digits[ count++ ] = char( '0' + seconds % 10 );
+                seconds /= 10;
+            } while( seconds != 0 );
+
+            char* pos = text;
+            if( offset < 0 )
+                *pos++ = '-';
+            while( count != 0 )
+                *pos++ = digits[ --count ];
+
+            if( mDecimals != 0 )
+            {
+                *pos++ = '.';
+                for( U32 i = mDecimals; i != 0; i-- )
+                {
+                    pos[ i - 1 ] = char( '0' + fraction % 10 );
+                    fraction /= 10;
+                }
+                pos += mDecimals;
+            }
+            *pos = 0;
+            return true;
+        }
+
+        U64 mTriggerSample;
+        U32 mSampleRate;
+        U32 mDecimals;
+        U64 mScale; // 10 ^ mDecimals
+        bool mFast;
+    };
+
+    void FormatTextChunk( TextChunk* chunk, const TimeFormatter* time_formatter, const LINAnalyzerResults* results,
+                          DisplayBase display_base )
+    {
+        chunk->mText.clear();
+        char time_str[ TimeFormatter::TextSize ];
+        for( size_t i = 0; i < chunk->mFields.size(); i++ )
+        {
+            const TextField& field = chunk->mFields[ i ];
+            if( field.mType == LineEnd )
+            {
+                chunk->mText.push_back( '\n' );
+                continue;
+            }
+
+            time_formatter->Format( field.mSample, time_str );
+            chunk->mText.insert( chunk->mText.end(), time_str, time_str + strlen( time_str ) );
+            chunk->mText.push_back( ',' );
+            const char* value = results->ByteText( field.mValue, display_base );
+            chunk->mText.insert( chunk->mText.end(), value, value + strlen( value ) );
+            if( field.mType == FieldComma )
+                chunk->mText.push_back( ',' );
+        }
+    }
+}
 
 LINAnalyzerResults::LINAnalyzerResults( LINAnalyzer* analyzer, LINAnalyzerSettings* settings )
     : AnalyzerResults(), mSettings( settings ), mAnalyzer( analyzer )
 {
+    // every frame value is a byte, so format each one once per display base instead of once per frame drawn.
+    for( U32 base = 0; base < DisplayBaseCount; base++ )
+    {
+        for( U32 value = 0; value < 256; value++ )
+            AnalyzerHelpers::GetNumberString( value, DisplayBase( base ), 8, mByteText[ base ][ value ], ByteTextSize );
+    }
 }
 
 LINAnalyzerResults::~LINAnalyzerResults()
 {
 }
 
+const char* LINAnalyzerResults::ByteText( U8 value, DisplayBase display_base ) const
+{
+    if( U32( display_base ) >= DisplayBaseCount )
+        display_base = Hexadecimal;
+    return mByteText[ display_base ][ value ];
+}
+
+bool LINAnalyzerResults::FormatFlags( U8 flags, char* text, U32 text_size ) const
+{
+    char* pos = text;
+    const char* end = text + text_size;
+    *pos = 0;
+    for( U32 flag = 0; flag < FlagCount; flag++ )
+    {
+        if( flags & ( 1 << flag ) )
+            pos = Append( pos, end, FlagText[ flag ] );
+    }
+    if( pos == text )
+        return false;
+
+    Append( pos, end, "!" );
+    return true;
+}
+
+void LINAnalyzerResults::FormatFrame( const Frame& frame, DisplayBase display_base, tLINTextLength length, char* text, U32 text_size ) const
+{
+    const char* end = text + text_size;
+    U32 type = frame.mType <= LINDecoder::responseChecksum ? frame.mType : U32( LINDecoder::NoFrame );
+    char* pos = Append( text, end, FrameLabels[ type ][ length ] );
+
+    switch( ( LINDecoder::tLINFrameState )type )
+    {
+    case LINDecoder::headerPID:
+        Append( pos, end, ByteText( U8( frame.mData1 & 0x3F ), display_base ) );
+        break;
+    case LINDecoder::responseDataZero:
+    case LINDecoder::responseData:
+        if( length != ShortText )
+        {
+            pos = Append( pos, end, ByteText( U8( frame.mData2 - 1 ), Decimal ) );
+            pos = Append( pos, end, ": " );
+        }
+        Append( pos, end, ByteText( U8( frame.mData1 ), display_base ) );
+        break;
+    case LINDecoder::responseChecksum:
+        Append( pos, end, ByteText( U8( frame.mData1 ), display_base ) );
+        break;
+    default:
+        break;
+    }
+}
 
-void LINAnalyzerResults::GenerateBubbleText( U64 frame_index, Channel& channel, DisplayBase display_base )
+void LINAnalyzerResults::GenerateBubbleText( U64 frame_index, Channel& /*channel*/, DisplayBase display_base )
 {
     ClearResultStrings();
     Frame frame = GetFrame( frame_index );
 
-    char number_str[ 128 ];
-    std::string fault_str;
-    std::string str[ 3 ];
-
-    if( frame.mFlags & byteFramingError )
-        fault_str += "!FRAME";
-    if( frame.mFlags & headerBreakExpected )
-        fault_str += "!BREAK";
-    if( frame.mFlags & headerSyncExpected )
-        fault_str += "!SYNC";
-    if( frame.mFlags & checksumMismatch )
-        fault_str += "!CHK";
-    if( fault_str.length() )
+    char text[ 3 ][ TextSize ];
+
+    if( FormatFlags( frame.mFlags, text[ 0 ], TextSize ) )
     {
-        fault_str += "!";
-        AddResultString( fault_str.c_str() );
+        AddResultString( text[ 0 ] );
 
         // display the error checksum if and only if the frame was a checksum and the only error was a checksum mismatch.
-        if( ( frame.mType == ( U8 )LINAnalyzerResults::responseChecksum ) && ( frame.mFlags == checksumMismatch ) )
+        if( ( frame.mType == ( U8 )LINDecoder::responseChecksum ) && ( frame.mFlags == LINDecoder::checksumMismatch ) )
+        {
+            const char* number = ByteText( U8( frame.mData1 ), display_base );
+            Append( Append( text[ 1 ], text[ 1 ] + TextSize, "!CHK ERR: " ), text[ 1 ] + TextSize, number );
+            Append( Append( text[ 2 ], text[ 2 ] + TextSize, "!Checksum mismatch: " ), text[ 2 ] + TextSize, number );
+            AddResultString( text[ 1 ] );
+            AddResultString( text[ 2 ] );
+        }
+        // likewise the whole PID byte, parity bits included, if its parity was the only error.
+        else if( ( frame.mType == ( U8 )LINDecoder::headerPID ) && ( frame.mFlags == LINDecoder::pidParityError ) )
         {
-            AnalyzerHelpers::GetNumberString( frame.mData1, display_base, 8, number_str, 128 );
-            str[ 0 ] = "!CHK ERR: ";
-            str[ 0 ] += number_str;
-            str[ 1 ] = "!Checksum mismatch: ";
-            str[ 1 ] += number_str;
-            AddResultString( str[ 0 ].c_str() );
-            AddResultString( str[ 1 ].c_str() );
+            const char* number = ByteText( U8( frame.mData1 ), display_base );
+            Append( Append( text[ 1 ], text[ 1 ] + TextSize, "!PAR ERR: " ), text[ 1 ] + TextSize, number );
+            Append( Append( text[ 2 ], text[ 2 ] + TextSize, "!PID parity error: " ), text[ 2 ] + TextSize, number );
+            AddResultString( text[ 1 ] );
+            AddResultString( text[ 2 ] );
         }
     }
     else
     {
-        AnalyzerHelpers::GetNumberString( frame.mData1, display_base, 8, number_str, 128 );
+        FormatFrame( frame, display_base, ShortText, text[ 0 ], TextSize );
+        FormatFrame( frame, display_base, MediumText, text[ 1 ], TextSize );
+        FormatFrame( frame, display_base, LongText, text[ 2 ], TextSize );
+        AddResultString( text[ 0 ] );
+        AddResultString( text[ 1 ] );
+        AddResultString( text[ 2 ] );
+    }
+}
 
-        switch( ( LINAnalyzerResults::tLINFrameState )frame.mType )
-        {
-        default:
-        case LINAnalyzerResults::NoFrame:
-            str[ 0 ] += "IBS";
-            str[ 1 ] += "IB Space";
-            str[ 2 ] += "Inter-Byte Space";
-            // AnalyzerHelpers::GetNumberString( frame.mData1, display_base, 8, str, 128 );
-            break;
-        case LINAnalyzerResults::headerBreak: // expecting break.
-            str[ 0 ] += "BRK";
-            str[ 1 ] += "Break";
-            str[ 2 ] += "Header Break";
-            break;
-        case LINAnalyzerResults::headerSync: // expecting sync.
-            str[ 0 ] += "SYN";
-            str[ 1 ] += "Sync";
-            str[ 2 ] += "Header Sync";
-            break;
-        case LINAnalyzerResults::headerPID: // expecting PID.
-            AnalyzerHelpers::GetNumberString( frame.mData1 & 0x3F, display_base, 8, number_str, 128 );
-            str[ 0 ] += number_str;
-
-            str[ 1 ] += "PID: ";
-            str[ 1 ] += number_str;
-
-            str[ 2 ] += "Protected ID: ";
-            str[ 2 ] += number_str;
-            break;
-        // LIN Response
-        case LINAnalyzerResults::responseDataZero: // expecting first resppnse data byte.
-        case LINAnalyzerResults::responseData:     // expecting response data.
-        {
-            char seq_str[ 128 ];
-            AnalyzerHelpers::GetNumberString( frame.mData2 - 1, Decimal, 8, seq_str, 128 );
-            str[ 0 ] += number_str;
-            str[ 1 ] += "D";
-            str[ 1 ] += seq_str;
-            str[ 1 ] += ": ";
-            str[ 1 ] += number_str;
-            str[ 2 ] += "Data ";
-            str[ 2 ] += seq_str;
-            str[ 2 ] += ": ";
-            str[ 2 ] += number_str;
-        }
+void LINAnalyzerResults::GenerateExportFile( const char* file, DisplayBase display_base, U32 export_type_user_id )
+{
+    switch( export_type_user_id )
+    {
+    case LINAnalyzerSettings::BinaryExport:
+        GenerateBinaryExport( file );
+        break;
+    case LINAnalyzerSettings::PcapExport:
+        GeneratePcapExport( file );
+        break;
+#if LIN_ANALYZER_STATS
+    case LINAnalyzerSettings::StatsExport:
+        GenerateStatsExport( file );
+        break;
+#endif
+    case LINAnalyzerSettings::TextExport:
+    default:
+        GenerateTextExport( file, display_base );
         break;
-        case LINAnalyzerResults::responseChecksum: // expecting checksum.
-            str[ 0 ] += number_str;
-            str[ 1 ] += "CHK: ";
-            str[ 1 ] += number_str;
-            str[ 2 ] += "Checksum: ";
-            str[ 2 ] += number_str;
-            break;
-
-        case LINAnalyzerResults::responsePotentialChecksum:
-            if( IsFrameChecksum( frame_index ) )
-            {
-                str[ 0 ] += number_str;
-                str[ 1 ] += "CHK: ";
-                str[ 1 ] += number_str;
-                str[ 2 ] += "Checksum: ";
-                str[ 2 ] += number_str;
-            }
-            else
-            {
-                char seq_str[ 128 ];
-                AnalyzerHelpers::GetNumberString( frame.mData2 - 1, Decimal, 8, seq_str, 128 );
-                str[ 0 ] += number_str;
-                str[ 1 ] += "D";
-                str[ 1 ] += seq_str;
-                str[ 1 ] += ": ";
-                str[ 1 ] += number_str;
-                str[ 2 ] += "Data ";
-                str[ 2 ] += seq_str;
-                str[ 2 ] += ": ";
-                str[ 2 ] += number_str;
-            }
-
-            break;
-        }
-
-        AddResultString( str[ 0 ].c_str() );
-        AddResultString( str[ 1 ].c_str() );
-        AddResultString( str[ 2 ].c_str() );
     }
 }
 
-void LINAnalyzerResults::GenerateExportFile( const char* file, DisplayBase display_base, U32 export_type_user_id )
+void LINAnalyzerResults::GenerateTextExport( const char* file, DisplayBase display_base )
 {
-    char time_str[ 128 ];
-    char number_str[ 128 ];
     std::ofstream file_stream( file, std::ios::out );
+    ExportBuffer buffer( file_stream );
+    TimeFormatter time_formatter( mAnalyzer->GetTriggerSample(), mAnalyzer->GetSampleRate() );
 
-    U64 trigger_sample = mAnalyzer->GetTriggerSample();
-    U32 sample_rate = mAnalyzer->GetSampleRate();
+    buffer.Append( "T.BREAK,BREAK,T.SYNC,SYNC,T.PID,PID,T.D,Dn...\n" );
 
-    file_stream << "T.BREAK,BREAK,T.SYNC,SYNC,T.PID,PID,T.D,Dn..." << std::endl;
+    // frames are read from the results on this thread only, a chunk of packets at a time. Formatting them, which is where the
+    // time goes, runs on worker threads, and the finished chunks are written in order, so the file is the same as a serial export.
+    U32 workers = std::thread::hardware_concurrency();
+    workers = workers < 1 ? 1 : ( workers > TextExportMaxWorkers ? TextExportMaxWorkers : workers );
+    const U32 depth = 2 * workers;
+    std::vector<TextChunk> chunks( depth );
+    std::vector<std::future<void> > formatting( depth );
 
     U64 num_frames = GetNumFrames();
-    for( U64 i = 0; i < num_frames; i++ )
+    U64 num_packets = GetNumPackets();
+    U64 packet_id = 0;
+    U64 gathered = 0; // chunks handed out, and written, so far.
+    U64 written = 0;
+    bool cancelled = false;
+    while( !cancelled && ( packet_id < num_packets || written < gathered ) )
     {
-        Frame frame = GetFrame( i );
-
-        if( frame.mType == headerBreak )
+        if( packet_id < num_packets && gathered - written < depth )
         {
-            U64 packet_id = GetPacketContainingFrameSequential( i );
+            TextChunk& chunk = chunks[ gathered % depth ];
+            chunk.mFields.clear();
 
-            if( packet_id != INVALID_RESULT_INDEX )
+            // one line per packet that starts with a break. The rest are traffic between LIN frames, and are skipped.
+            for( U32 packets = 0; packets < TextChunkPackets && packet_id < num_packets; packets++, packet_id++ )
             {
                 U64 first_frame;
-                U64 last_frame;
+                GetFramesContainedInPacket( packet_id, &first_frame, &chunk.mLastFrame );
+                if( GetFrame( first_frame ).mType != LINDecoder::headerBreak )
+                    continue;
 
-                GetFramesContainedInPacket( packet_id, &first_frame, &last_frame );
-                // export header time
-                for( U64 j = first_frame; j <= last_frame; ++j )
+                for( U64 j = first_frame; j <= chunk.mLastFrame; ++j )
                 {
-                    frame = GetFrame( j );
+                    Frame frame = GetFrame( j );
                     if( frame.mType == 0 )
                         continue; // skip IBS frames.
 
                     U64 data = frame.mData1;
-                    if( ( LINAnalyzerResults::tLINFrameState )frame.mType == LINAnalyzerResults::headerPID )
+                    if( ( LINDecoder::tLINFrameState )frame.mType == LINDecoder::headerPID )
                         data = data & 0x3F; // trim the upper 2 bits from the PID frame during eport.
 
-                    AnalyzerHelpers::GetTimeString( frame.mStartingSampleInclusive, trigger_sample, sample_rate, time_str, 128 );
-                    AnalyzerHelpers::GetNumberString( data, display_base, 8, number_str, 128 );
-                    file_stream << time_str << "," << number_str;
-                    if( j < last_frame )
-                        file_stream << ",";
+                    TextField field = { U64( frame.mStartingSampleInclusive ), U8( data ), j < chunk.mLastFrame ? FieldComma : FieldOnly };
+                    chunk.mFields.push_back( field );
                 }
 
-                file_stream << std::endl;
+                TextField line_end = { 0, 0, LineEnd };
+                chunk.mFields.push_back( line_end );
+            }
 
-                i = last_frame;
+            try
+            {
+                formatting[ gathered % depth ] =
+                    std::async( std::launch::async, FormatTextChunk, &chunk, &time_formatter, this, display_base );
+            }
+            catch( const std::system_error& )
+            {
+                FormatTextChunk( &chunk, &time_formatter, this, display_base ); // no threads to be had; format it here instead.
             }
+            ++gathered;
         }
-
-        if( UpdateExportProgressAndCheckForCancel( i, num_frames ) == true )
+        else
         {
-            file_stream.close();
-            return;
+            TextChunk& chunk = chunks[ written % depth ];
+            if( formatting[ written % depth ].valid() )
+                formatting[ written % depth ].get();
+            if( !chunk.mText.empty() )
+                buffer.Append( &chunk.mText[ 0 ], chunk.mText.size() );
+            ++written;
+
+            if( UpdateExportProgressAndCheckForCancel( chunk.mLastFrame, num_frames ) == true )
+                cancelled = true;
         }
     }
 
-    UpdateExportProgressAndCheckForCancel( 0, 0 );
+    // chunks still being formatted refer to this frame; let them finish before leaving.
+    for( U32 i = 0; i < depth; i++ )
+    {
+        if( formatting[ i ].valid() )
+            formatting[ i ].wait();
+    }
+
+    if( !cancelled )
+        UpdateExportProgressAndCheckForCancel( 0, 0 );
 
+    buffer.Flush();
     file_stream.close();
 }
 
-void LINAnalyzerResults::GenerateFrameTabularText( U64 frame_index, DisplayBase display_base )
+void LINAnalyzerResults::GenerateBinaryExport( const char* file )
 {
-    ClearTabularText();
+    // the first pass counts the frames of each ID, which fixes where every column and index list starts.
+    U64 num_frames = GetNumFrames();
+    U64 num_packets = GetNumPackets();
+    U64 id_counts[ LINFrameTableIndexEntries ] = { 0 };
+    LINDecoder::LINFrame lin_frame;
+    U64 last_frame;
+    for( U64 packet_id = 0; packet_id < num_packets; packet_id++ )
+    {
+        if( GetLINFrame( packet_id, lin_frame, last_frame ) )
+            ++id_counts[ lin_frame.mHasPID ? ( lin_frame.mPID & 0x3F ) : LINFrameTableIndexEntries - 1 ];
 
-    Frame frame = GetFrame( frame_index );
+        if( UpdateExportProgressAndCheckForCancel( last_frame, 2 * num_frames ) == true )
+            return;
+    }
 
-    char number_str[ 128 ];
-    std::string fault_str;
-    std::string str;
-
-    if( frame.mFlags & byteFramingError )
-        fault_str += "!FRAME";
-    if( frame.mFlags & headerBreakExpected )
-        fault_str += "!BREAK";
-    if( frame.mFlags & headerSyncExpected )
-        fault_str += "!SYNC";
-    if( frame.mFlags & checksumMismatch )
-        fault_str += "!CHK";
-    if( fault_str.length() )
+    LINFrameTableWriter writer;
+    if( !writer.Open( file, mAnalyzer->GetSampleRate(), mAnalyzer->GetTriggerSample(), id_counts ) )
+        return;
+
+    // the second pass fills in the columns and the index lists.
+    LINFrameTableRecord record;
+    for( U64 packet_id = 0; packet_id < num_packets; packet_id++ )
     {
-        fault_str += "!";
-        AddTabularText( fault_str.c_str() );
+        if( GetLINFrame( packet_id, lin_frame, last_frame ) )
+        {
+            LINFrameTableWriter::MakeRecord( lin_frame, record );
+            writer.Add( record );
+        }
+
+        if( UpdateExportProgressAndCheckForCancel( num_frames + last_frame, 2 * num_frames ) == true )
+        {
+            writer.Close();
+            return;
+        }
     }
-    else
+
+    writer.Close();
+    UpdateExportProgressAndCheckForCancel( 0, 0 );
+}
+
+void LINAnalyzerResults::GeneratePcapExport( const char* file )
+{
+    std::ofstream file_stream( file, std::ios::out | std::ios::binary );
+    ExportBuffer buffer( file_stream );
+
+    U8 header[ 24 ];
+    PutLittleEndian( &header[ 0 ], PcapNanosecondMagic, 4 );
+    PutLittleEndian( &header[ 4 ], 2, 2 ); // version 2.4
+    PutLittleEndian( &header[ 6 ], 4, 2 );
+    PutLittleEndian( &header[ 8 ], 0, 4 );  // time zone
+    PutLittleEndian( &header[ 12 ], 0, 4 ); // timestamp accuracy
+    PutLittleEndian( &header[ 16 ], 65535, 4 );
+    PutLittleEndian( &header[ 20 ], PcapLinkTypeLIN, 4 );
+    buffer.Append( reinterpret_cast<const char*>( header ), sizeof( header ) );
+
+    // there's no wall clock time in a capture; timestamps count from its first sample.
+    const U64 sample_rate = mAnalyzer->GetSampleRate();
+    U64 num_frames = GetNumFrames();
+    U64 num_packets = GetNumPackets();
+    LINDecoder::LINFrame lin_frame;
+    U64 last_frame;
+    for( U64 packet_id = 0; packet_id < num_packets; packet_id++ )
     {
-        AnalyzerHelpers::GetNumberString( frame.mData1, display_base, 8, number_str, 128 );
+        // the pseudo-header has no way to say the PID is missing, so frames that ended in the header are left out.
+        if( GetLINFrame( packet_id, lin_frame, last_frame ) && lin_frame.mHasPID )
+        {
+            const U8 data_length = lin_frame.mResponseLength > 0 ? U8( lin_frame.mResponseLength - 1 ) : 0;
+            const U8 checksum = lin_frame.mResponseLength > 0 ? lin_frame.mResponse[ data_length ] : 0;
+            U8 errors = 0;
+            if( lin_frame.mResponseLength == 0 )
+                errors |= PcapLINNoSlaveResponse;
+            if( lin_frame.mFlags & ( LINDecoder::byteFramingError | LINDecoder::headerBreakExpected | LINDecoder::headerSyncExpected ) )
+                errors |= PcapLINFramingError;
+            if( !LINValidPIDs[ lin_frame.mPID ] )
+                errors |= PcapLINParityError;
+            if( lin_frame.mFlags & LINDecoder::checksumMismatch )
+                errors |= PcapLINChecksumError;
+
+            const U32 length = PcapLINHeaderSize + data_length;
+            U8 record[ 16 + PcapLINHeaderSize + 8 ];
+            const U64 timestamp = U64( lin_frame.mStartingSample );
+            PutLittleEndian( &record[ 0 ], timestamp / sample_rate, 4 );
+            PutLittleEndian( &record[ 4 ], ( timestamp % sample_rate ) * 1000000000ull / sample_rate, 4 );
+            PutLittleEndian( &record[ 8 ], length, 4 );
+            PutLittleEndian( &record[ 12 ], length, 4 );
+
+            U8* lin_header = &record[ 16 ];
+            lin_header[ 0 ] = PcapLINFormatRevision;
+            lin_header[ 1 ] = 0;
+            lin_header[ 2 ] = 0;
+            lin_header[ 3 ] = 0;
+            lin_header[ 4 ] = U8( data_length << 4 ) | ( lin_frame.mEnhancedChecksum ? PcapLINEnhancedChecksum : PcapLINClassicChecksum );
+            lin_header[ 5 ] = lin_frame.mPID;
+            lin_header[ 6 ] = checksum;
+            lin_header[ 7 ] = errors;
+            memcpy( &lin_header[ PcapLINHeaderSize ], lin_frame.mResponse, data_length );
+
+            buffer.Append( reinterpret_cast<const char*>( record ), 16 + length );
+        }
 
-        switch( ( LINAnalyzerResults::tLINFrameState )frame.mType )
+        if( UpdateExportProgressAndCheckForCancel( last_frame, num_frames ) == true )
         {
-        default:
-        case LINAnalyzerResults::NoFrame:
+            buffer.Flush();
+            file_stream.close();
+            return;
+        }
+    }
 
-            str += "Inter-Byte Space";
-            // AnalyzerHelpers::GetNumberString( frame.mData1, display_base, 8, str, 128 );
-            break;
+    UpdateExportProgressAndCheckForCancel( 0, 0 );
 
-        case LINAnalyzerResults::headerBreak: // expecting break.
+    buffer.Flush();
+    file_stream.close();
+}
 
-            str += "Header Break";
-            break;
+#if LIN_ANALYZER_STATS
+// one "name,value" line per counter, then the estimated time in each frame state, in seconds.
+void LINAnalyzerResults::GenerateStatsExport( const char* file )
+{
+    std::ofstream file_stream( file, std::ios::out );
+    const LINAnalyzerStats& stats = mAnalyzer->GetStats();
 
-        case LINAnalyzerResults::headerSync: // expecting sync.
+    file_stream << "name,value\n";
+    for( U32 counter = 0; counter < LINAnalyzerStats::CounterCount; counter++ )
+        file_stream << LINAnalyzerStats::GetCounterName( static_cast<LINAnalyzerStats::tLINCounter>( counter ) ) << ','
+                    << stats.mCounters[ counter ] << '\n';
+    for( U32 state = 0; state < LINAnalyzerStats::StateCount; state++ )
+        file_stream << LINAnalyzerStats::GetStateTimeName( state ) << ',' << stats.mStateSeconds[ state ] << '\n';
 
-            str += "Header Sync";
-            break;
+    UpdateExportProgressAndCheckForCancel( 0, 0 );
+    file_stream.close();
+}
+#endif
 
-        case LINAnalyzerResults::headerPID: // expecting PID.
+bool LINAnalyzerResults::GetLINFrame( U64 packet_id, LINDecoder::LINFrame& lin_frame, U64& last_frame )
+{
+    U64 first_frame;
+    GetFramesContainedInPacket( packet_id, &first_frame, &last_frame );
 
-            AnalyzerHelpers::GetNumberString( frame.mData1 & 0x3F, display_base, 8, number_str, 128 );
-            str += "Protected ID: ";
-            str += number_str;
-            break;
+    if( GetFrame( first_frame ).mType != LINDecoder::headerBreak )
+        return false;
 
-        // LIN Response
-        case LINAnalyzerResults::responseDataZero: // expecting first resppnse data byte.
-        case LINAnalyzerResults::responseData:     // expecting response data.
-        {
-            char seq_str[ 128 ];
-            AnalyzerHelpers::GetNumberString( frame.mData2 - 1, Decimal, 8, seq_str, 128 );
-            str += "Data ";
-            str += seq_str;
-            str += ": ";
-            str += number_str;
-        }
-        break;
-        case LINAnalyzerResults::responseChecksum: // expecting checksum.
-            str += "Checksum: ";
-            str += number_str;
-            break;
-        case LINAnalyzerResults::responsePotentialChecksum:
-            if( IsFrameChecksum( frame_index ) )
-            {
-                str += "Checksum: ";
-                str += number_str;
-            }
-            else
-            {
-                char seq_str[ 128 ];
-                AnalyzerHelpers::GetNumberString( frame.mData2 - 1, Decimal, 8, seq_str, 128 );
-                str += "Data ";
-                str += seq_str;
-                str += ": ";
-                str += number_str;
-            }
+    // the byte frames go through the same steps as the decoder's fields did; the inter-byte spaces never reached it.
+    LINDecoder::Field field;
+    field.mDataBytes = 0;
+    field.mEndsPacket = false;
+    for( U64 i = first_frame; i <= last_frame; i++ )
+    {
+        const Frame frame = GetFrame( i );
+        if( frame.mType == LINDecoder::NoFrame )
+            continue;
+        field.mStartingSample = frame.mStartingSampleInclusive;
+        field.mEndingSample = frame.mEndingSampleInclusive;
+        field.mType = frame.mType;
+        field.mData = U8( frame.mData1 );
+        field.mFlags = frame.mFlags;
+        field.mStartsPacket = i == first_frame;
+        LINDecoder::AddToLINFrame( lin_frame, field );
+    }
+    LINDecoder::CheckLINFrame( lin_frame, lin_frame.mHasPID && mAnalyzer->UsesEnhancedChecksum( lin_frame.mPID & 0x3F ) );
+    return true;
+}
 
-            break;
-        }
+void LINAnalyzerResults::GenerateFrameTabularText( U64 frame_index, DisplayBase display_base )
+{
+    ClearTabularText();
 
-        AddTabularText( str.c_str() );
-    }
+    Frame frame = GetFrame( frame_index );
+
+    char text[ TextSize ];
+    if( !FormatFlags( frame.mFlags, text, TextSize ) )
+        FormatFrame( frame, display_base, LongText, text, TextSize );
+    AddTabularText( text );
 }
 
-void LINAnalyzerResults::GeneratePacketTabularText( U64 packet_id, DisplayBase display_base )
+void LINAnalyzerResults::GeneratePacketTabularText( U64 /*packet_id*/, DisplayBase /*display_base*/ )
 {
     ClearResultStrings();
     AddResultString( "not supported" );
 }
 
-void LINAnalyzerResults::GenerateTransactionTabularText( U64 transaction_id, DisplayBase display_base )
+void LINAnalyzerResults::GenerateTransactionTabularText( U64 /*transaction_id*/, DisplayBase /*display_base*/ )
 {
     ClearResultStrings();
     AddResultString( "not supported" );
 }
-
-bool LINAnalyzerResults::IsFrameChecksum( U64 frame_index )
-{
-    U64 packet_id = GetPacketContainingFrame( frame_index );
-    if( packet_id != INVALID_RESULT_INDEX )
-    {
-        U64 first_frame;
-        U64 last_frame;
-
-        GetFramesContainedInPacket( packet_id, &first_frame, &last_frame );
-
-        if( last_frame == frame_index )
-            return true;
-    }
-
-    return false;
-}
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define LIN_ANALYZER_RESULTS
 
 #include <AnalyzerResults.h>
+#include "LINDecoder.h"
 
 class LINAnalyzer;
 class LINAnalyzerSettings;
@@ -11,26 +12,10 @@ class LINAnalyzerResults : public AnalyzerResults
   public:
     typedef enum
     {
-        NoFrame = 0, // no frame recognized.
-        // LIN Header
-        headerBreak, // expecting break.
-        headerSync,  // expecting sync.
-        headerPID,   // expecting PID.
-        // LIN Response
-        responseDataZero,         // expecting first data byte.
-        responseData,             // expecting response data.
-        responseChecksum,         // expecting checksum.
-        responsePotentialChecksum // could be a data frame or a checksum. used in results only.
-    } tLINFrameState;
-
-    typedef enum
-    {
-        Okay = 0x00,
-        byteFramingError = 0x01,
-        headerBreakExpected = 0x02,
-        headerSyncExpected = 0x04,
-        checksumMismatch = 0x08,
-    } tLINFrameFlags;
+        ShortText = 0, // "0x5A"
+        MediumText,    // "CHK: 0x5A"
+        LongText       // "Checksum: 0x5A"
+    } tLINTextLength;
 
     LINAnalyzerResults( LINAnalyzer* analyzer, LINAnalyzerSettings* settings );
     virtual ~LINAnalyzerResults();
@@ -42,12 +27,34 @@ class LINAnalyzerResults : public AnalyzerResults
     virtual void GeneratePacketTabularText( U64 packet_id, DisplayBase display_base );
     virtual void GenerateTransactionTabularText( U64 transaction_id, DisplayBase display_base );
 
+    // shared by the bubble, tabular and export text. None of these touch the heap.
+    const char* ByteText( U8 value, DisplayBase display_base ) const;
+    bool FormatFlags( U8 flags, char* text, U32 text_size ) const; // false, and no text, if there are no error flags.
+    void FormatFrame( const Frame& frame, DisplayBase display_base, tLINTextLength length, char* text, U32 text_size ) const;
+
+    // the LIN frame of a packet, put back together from its byte frames the way the decoder reported it, for the frame level
+    // exports. False if the packet doesn't start with a break.
+    bool GetLINFrame( U64 packet_id, LINDecoder::LINFrame& lin_frame, U64& last_frame );
+
   protected: // functions
-    bool IsFrameChecksum( U64 frame_index );
+    void GenerateTextExport( const char* file, DisplayBase display_base );
+    void GenerateBinaryExport( const char* file );
+    void GeneratePcapExport( const char* file );
+#if LIN_ANALYZER_STATS
+    void GenerateStatsExport( const char* file );
+#endif
 
   protected: // vars
     LINAnalyzerSettings* mSettings;
     LINAnalyzer* mAnalyzer;
+
+    enum
+    {
+        DisplayBaseCount = AsciiHex + 1,
+        ByteTextSize = 32,
+        TextSize = 128
+    };
+    char mByteText[ DisplayBaseCount ][ 256 ][ ByteTextSize ]; // GetNumberString() of every byte value, per display base.
 };
 
 #endif // LIN_ANALYZER_RESULTS
@@ -1,8 +1,22 @@
 #include "LINAnalyzerSettings.h"
+#include "LINFrameTableReader.h"
 #include <AnalyzerHelpers.h>
 
 
-LINAnalyzerSettings::LINAnalyzerSettings() : mInputChannel( UNDEFINED_CHANNEL ), mLINVersion( 2.0 ), mBitRate( 20000 )
+LINAnalyzerSettings::LINAnalyzerSettings()
+    : mInputChannel( UNDEFINED_CHANNEL ),
+      mLINVersion( 2.0 ),
+      mBitRate( 20000 ),
+      mMarkerDensity( AllMarkers ),
+      mCommitPolicy( CommitLowLatency ),
+      mCommitFrames( 1000 ),
+      mCommitIntervalMs( 100 ),
+      mFrameOutput( ByteFrameOutput ),
+      mSimulationTraffic( SimulateRandom ),
+      mSimulationSeed( 1 ),
+      mSimulationBusLoad( 100 ),
+      mSimulationErrorRate( 0 ),
+      mSimulationImpairments( ImpairNone )
 {
     mInputChannelInterface.reset( new AnalyzerSettingInterfaceChannel() );
     mInputChannelInterface->SetTitleAndTooltip( "Serial", "Standard LIN" );
@@ -20,13 +34,129 @@ LINAnalyzerSettings::LINAnalyzerSettings() : mInputChannel( UNDEFINED_CHANNEL ),
     mBitRateInterface->SetMin( 1000 );
     mBitRateInterface->SetInteger( mBitRate );
 
+    mMarkerDensityInterface.reset( new AnalyzerSettingInterfaceNumberList() );
+    mMarkerDensityInterface->SetTitleAndTooltip( "Markers", "Choose which bit markers are drawn on the waveform. Fewer markers use less "
+                                                            "memory and decode faster on long captures." );
+    mMarkerDensityInterface->AddNumber( AllMarkers, "All bits", "Mark every sampled bit, start and stop bits, and errors" );
+    mMarkerDensityInterface->AddNumber( StartStopMarkers, "Start/stop bits and errors", "Mark start and stop bits, and errors" );
+    mMarkerDensityInterface->AddNumber( ErrorMarkersOnly, "Errors only", "Only mark framing errors" );
+    mMarkerDensityInterface->SetNumber( mMarkerDensity );
+
+    mCommitPolicyInterface.reset( new AnalyzerSettingInterfaceNumberList() );
+    mCommitPolicyInterface->SetTitleAndTooltip( "Result Updates", "Choose how often decoded results are handed to the display." );
+    mCommitPolicyInterface->AddNumber( CommitLowLatency, "Live",
+                                       "Show each header as soon as it is decoded, and each packet when it ends" );
+    mCommitPolicyInterface->AddNumber( CommitPerPacket, "Per packet", "Show results once per packet" );
+    mCommitPolicyInterface->AddNumber( CommitBatched, "Batched",
+                                       "Show results in batches, limited by the batch frame count and interval. Fastest on long captures" );
+    mCommitPolicyInterface->SetNumber( mCommitPolicy );
+
+    mCommitFramesInterface.reset( new AnalyzerSettingInterfaceInteger() );
+    mCommitFramesInterface->SetTitleAndTooltip( "Batch Frames", "Batched updates: the most frames decoded between updates." );
+    mCommitFramesInterface->SetMax( 1000000 );
+    mCommitFramesInterface->SetMin( 1 );
+    mCommitFramesInterface->SetInteger( mCommitFrames );
+
+    mCommitIntervalMsInterface.reset( new AnalyzerSettingInterfaceInteger() );
+    mCommitIntervalMsInterface->SetTitleAndTooltip( "Batch Interval (ms)",
+                                                    "Batched updates: the most capture time, in milliseconds, decoded between updates." );
+    mCommitIntervalMsInterface->SetMax( 3600000 );
+    mCommitIntervalMsInterface->SetMin( 1 );
+    mCommitIntervalMsInterface->SetInteger( mCommitIntervalMs );
+
+    mFrameOutputInterface.reset( new AnalyzerSettingInterfaceNumberList() );
+    mFrameOutputInterface->SetTitleAndTooltip( "Frame Output", "Choose the records passed to the data table and high level analyzers." );
+    mFrameOutputInterface->AddNumber( ByteFrameOutput, "Bytes", "One record per byte: break, sync, PID, data and checksum" );
+    mFrameOutputInterface->AddNumber( LINFrameOutput, "LIN frames",
+                                      "One \"lin_frame\" record per LIN frame, with the ID, data and checksum" );
+    mFrameOutputInterface->SetNumber( mFrameOutput );
+
+    mDescriptionFileInterface.reset( new AnalyzerSettingInterfaceText() );
+    mDescriptionFileInterface->SetTitleAndTooltip( "LIN Description File (optional)",
+                                                   "An LDF giving the response length and checksum model of each frame ID. Without one, "
+                                                   "the end of each response is guessed from the checksum." );
+    mDescriptionFileInterface->SetTextType( AnalyzerSettingInterfaceText::FilePath );
+    mDescriptionFileInterface->SetText( mDescriptionFile.c_str() );
+
+    mSimulationTrafficInterface.reset( new AnalyzerSettingInterfaceNumberList() );
+    mSimulationTrafficInterface->SetTitleAndTooltip( "Simulation Traffic", "Choose the frames the simulator sends." );
+    mSimulationTrafficInterface->AddNumber( SimulateRandom, "Random", "Random identifiers and response lengths" );
+    mSimulationTrafficInterface->AddNumber( SimulateSchedule, "Schedule table",
+                                            "The frames of the description file in identifier order, repeated. Without a "
+                                            "description file, every identifier with its LIN 1.x length" );
+    mSimulationTrafficInterface->AddNumber( SimulateReplay, "Replay trace",
+                                            "The frames of a binary LIN frame table export, at the times they were recorded" );
+    mSimulationTrafficInterface->SetNumber( mSimulationTraffic );
+
+    mSimulationTraceFileInterface.reset( new AnalyzerSettingInterfaceText() );
+    mSimulationTraceFileInterface->SetTitleAndTooltip( "Simulation Trace File",
+                                                       "Replay trace: a file saved with \"Export as binary LIN frame table\"." );
+    mSimulationTraceFileInterface->SetTextType( AnalyzerSettingInterfaceText::FilePath );
+    mSimulationTraceFileInterface->SetText( mSimulationTraceFile.c_str() );
+
+    mSimulationSeedInterface.reset( new AnalyzerSettingInterfaceInteger() );
+    mSimulationSeedInterface->SetTitleAndTooltip( "Simulation Seed", "The same seed simulates the same waveform every time." );
+    mSimulationSeedInterface->SetMax( 0x7FFFFFFF );
+    mSimulationSeedInterface->SetMin( 0 );
+    mSimulationSeedInterface->SetInteger( mSimulationSeed );
+
+    mSimulationBusLoadInterface.reset( new AnalyzerSettingInterfaceInteger() );
+    mSimulationBusLoadInterface->SetTitleAndTooltip( "Simulation Bus Load (%)",
+                                                     "Roughly how much of the simulated bus time is spent sending frames." );
+    mSimulationBusLoadInterface->SetMax( 100 );
+    mSimulationBusLoadInterface->SetMin( 1 );
+    mSimulationBusLoadInterface->SetInteger( mSimulationBusLoad );
+
+    mSimulationErrorRateInterface.reset( new AnalyzerSettingInterfaceInteger() );
+    mSimulationErrorRateInterface->SetTitleAndTooltip( "Simulation Errors (per 1000 frames)",
+                                                       "How many simulated frames in every 1000 have a checksum, parity or framing "
+                                                       "error, shared evenly between the three." );
+    mSimulationErrorRateInterface->SetMax( 1000 );
+    mSimulationErrorRateInterface->SetMin( 0 );
+    mSimulationErrorRateInterface->SetInteger( mSimulationErrorRate );
+
+    mSimulationImpairmentsInterface.reset( new AnalyzerSettingInterfaceNumberList() );
+    mSimulationImpairmentsInterface->SetTitleAndTooltip( "Simulation Bus Quality",
+                                                         "Choose how far the simulated waveform is from ideal bit timing." );
+    mSimulationImpairmentsInterface->AddNumber( ImpairNone, "Ideal", "Exact bit timing" );
+    mSimulationImpairmentsInterface->AddNumber( ImpairMild, "Mild impairments",
+                                                "Slave clock drift up to 2%, varied byte spacing, breaks 13 to 15 bits long and the "
+                                                "odd glitch" );
+    mSimulationImpairmentsInterface->AddNumber( ImpairHarsh, "Harsh impairments",
+                                                "Slave clock drift up to 14%, long spaces, breaks 9 to 17 bits long and frequent "
+                                                "glitches" );
+    mSimulationImpairmentsInterface->SetNumber( mSimulationImpairments );
+
     AddInterface( mInputChannelInterface.get() );
     AddInterface( mLINVersionInterface.get() );
     AddInterface( mBitRateInterface.get() );
+    AddInterface( mMarkerDensityInterface.get() );
+    AddInterface( mCommitPolicyInterface.get() );
+    AddInterface( mCommitFramesInterface.get() );
+    AddInterface( mCommitIntervalMsInterface.get() );
+    AddInterface( mFrameOutputInterface.get() );
+    AddInterface( mDescriptionFileInterface.get() );
+    AddInterface( mSimulationTrafficInterface.get() );
+    AddInterface( mSimulationTraceFileInterface.get() );
+    AddInterface( mSimulationSeedInterface.get() );
+    AddInterface( mSimulationBusLoadInterface.get() );
+    AddInterface( mSimulationErrorRateInterface.get() );
+    AddInterface( mSimulationImpairmentsInterface.get() );
+
+    AddExportOption( TextExport, "Export as text/csv file" );
+    AddExportExtension( TextExport, "text", "txt" );
+    AddExportExtension( TextExport, "csv", "csv" );
 
-    AddExportOption( 0, "Export as text/csv file" );
-    AddExportExtension( 0, "text", "txt" );
-    AddExportExtension( 0, "csv", "csv" );
+    AddExportOption( BinaryExport, "Export as binary LIN frame table" );
+    AddExportExtension( BinaryExport, "LIN frame table", "linbin" );
+
+    AddExportOption( PcapExport, "Export as pcap file" );
+    AddExportExtension( PcapExport, "pcap", "pcap" );
+
+#if LIN_ANALYZER_STATS
+    AddExportOption( StatsExport, "Export decoder statistics" );
+    AddExportExtension( StatsExport, "csv", "csv" );
+#endif
 
     ClearChannels();
     AddChannel( mInputChannel, "Serial", false );
@@ -38,9 +168,31 @@ LINAnalyzerSettings::~LINAnalyzerSettings()
 
 bool LINAnalyzerSettings::SetSettingsFromInterfaces()
 {
+    if( U32( mSimulationTrafficInterface->GetNumber() ) == SimulateReplay )
+    {
+        LINFrameTableReader trace;
+        if( !trace.Open( mSimulationTraceFileInterface->GetText() ) )
+        {
+            SetErrorText( "The simulation trace file can't be read, or isn't a binary LIN frame table export." );
+            return false;
+        }
+    }
+
     mInputChannel = mInputChannelInterface->GetChannel();
     mLINVersion = mLINVersionInterface->GetNumber();
     mBitRate = mBitRateInterface->GetInteger();
+    mMarkerDensity = tLINMarkerDensity( U32( mMarkerDensityInterface->GetNumber() ) );
+    mCommitPolicy = tLINCommitPolicy( U32( mCommitPolicyInterface->GetNumber() ) );
+    mCommitFrames = mCommitFramesInterface->GetInteger();
+    mCommitIntervalMs = mCommitIntervalMsInterface->GetInteger();
+    mFrameOutput = tLINFrameOutput( U32( mFrameOutputInterface->GetNumber() ) );
+    mDescriptionFile = mDescriptionFileInterface->GetText();
+    mSimulationTraffic = tLINSimulationTraffic( U32( mSimulationTrafficInterface->GetNumber() ) );
+    mSimulationTraceFile = mSimulationTraceFileInterface->GetText();
+    mSimulationSeed = mSimulationSeedInterface->GetInteger();
+    mSimulationBusLoad = mSimulationBusLoadInterface->GetInteger();
+    mSimulationErrorRate = mSimulationErrorRateInterface->GetInteger();
+    mSimulationImpairments = tLINSimulationImpairments( U32( mSimulationImpairmentsInterface->GetNumber() ) );
 
     ClearChannels();
     AddChannel( mInputChannel, "LIN", true );
@@ -53,6 +205,18 @@ void LINAnalyzerSettings::UpdateInterfacesFromSettings()
     mInputChannelInterface->SetChannel( mInputChannel );
     mLINVersionInterface->SetNumber( mLINVersion );
     mBitRateInterface->SetInteger( mBitRate );
+    mMarkerDensityInterface->SetNumber( mMarkerDensity );
+    mCommitPolicyInterface->SetNumber( mCommitPolicy );
+    mCommitFramesInterface->SetInteger( mCommitFrames );
+    mCommitIntervalMsInterface->SetInteger( mCommitIntervalMs );
+    mFrameOutputInterface->SetNumber( mFrameOutput );
+    mDescriptionFileInterface->SetText( mDescriptionFile.c_str() );
+    mSimulationTrafficInterface->SetNumber( mSimulationTraffic );
+    mSimulationTraceFileInterface->SetText( mSimulationTraceFile.c_str() );
+    mSimulationSeedInterface->SetInteger( mSimulationSeed );
+    mSimulationBusLoadInterface->SetInteger( mSimulationBusLoad );
+    mSimulationErrorRateInterface->SetInteger( mSimulationErrorRate );
+    mSimulationImpairmentsInterface->SetNumber( mSimulationImpairments );
 }
 
 void LINAnalyzerSettings::LoadSettings( const char* settings )
@@ -64,6 +228,34 @@ void LINAnalyzerSettings::LoadSettings( const char* settings )
     text_archive >> mBitRate;
     text_archive >> mLINVersion;
 
+    // settings saved before this option existed keep the default.
+    U32 marker_density;
+    if( text_archive >> marker_density )
+        mMarkerDensity = tLINMarkerDensity( marker_density );
+    U32 commit_policy;
+    if( text_archive >> commit_policy )
+        mCommitPolicy = tLINCommitPolicy( commit_policy );
+    text_archive >> mCommitFrames;
+    text_archive >> mCommitIntervalMs;
+    U32 frame_output;
+    if( text_archive >> frame_output )
+        mFrameOutput = tLINFrameOutput( frame_output );
+    const char* description_file;
+    if( text_archive >> &description_file )
+        mDescriptionFile = description_file;
+    U32 simulation_traffic;
+    if( text_archive >> simulation_traffic )
+        mSimulationTraffic = tLINSimulationTraffic( simulation_traffic );
+    text_archive >> mSimulationSeed;
+    text_archive >> mSimulationBusLoad;
+    text_archive >> mSimulationErrorRate;
+    U32 simulation_impairments;
+    if( text_archive >> simulation_impairments )
+        mSimulationImpairments = tLINSimulationImpairments( simulation_impairments );
+    const char* simulation_trace_file;
+    if( text_archive >> &simulation_trace_file )
+        mSimulationTraceFile = simulation_trace_file;
+
     ClearChannels();
     AddChannel( mInputChannel, "LIN", true );
 
@@ -77,6 +269,18 @@ const char* LINAnalyzerSettings::SaveSettings()
     text_archive << mInputChannel;
     text_archive << mBitRate;
     text_archive << mLINVersion;
+    text_archive << U32( mMarkerDensity );
+    text_archive << U32( mCommitPolicy );
+    text_archive << mCommitFrames;
+    text_archive << mCommitIntervalMs;
+    text_archive << U32( mFrameOutput );
+    text_archive << mDescriptionFile.c_str();
+    text_archive << U32( mSimulationTraffic );
+    text_archive << mSimulationSeed;
+    text_archive << mSimulationBusLoad;
+    text_archive << mSimulationErrorRate;
+    text_archive << U32( mSimulationImpairments );
+    text_archive << mSimulationTraceFile.c_str();
 
     return SetReturnString( text_archive.GetString() );
 }
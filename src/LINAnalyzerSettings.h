@@ -3,10 +3,53 @@
 
 #include <AnalyzerSettings.h>
 #include <AnalyzerTypes.h>
+#include <string>
 
 class LINAnalyzerSettings : public AnalyzerSettings
 {
   public:
+    typedef enum
+    {
+        AllMarkers = 0,        // every sampled bit, plus start/stop bits and errors.
+        StartStopMarkers = 1,  // start/stop bits and errors.
+        ErrorMarkersOnly = 2,  // framing errors only.
+    } tLINMarkerDensity;
+
+    typedef enum
+    {
+        CommitLowLatency = 0, // after every header and every packet, for live monitoring.
+        CommitPerPacket = 1,  // after every packet.
+        CommitBatched = 2,    // after a number of frames or a span of capture time, for throughput.
+    } tLINCommitPolicy;
+
+    typedef enum
+    {
+        ByteFrameOutput = 0, // one FrameV2 record per byte.
+        LINFrameOutput = 1,  // one "lin_frame" FrameV2 record per LIN frame.
+    } tLINFrameOutput;
+
+    typedef enum
+    {
+        TextExport = 0,   // one CSV line per LIN frame.
+        BinaryExport = 1, // fixed width columns with a per-ID index, see README.md.
+        PcapExport = 2,   // pcap file of LINKTYPE_LIN records.
+        StatsExport = 3,  // decoder counters, LIN_ANALYZER_STATS builds only.
+    } tLINExportType;
+
+    typedef enum
+    {
+        SimulateRandom = 0,   // random identifiers and lengths.
+        SimulateSchedule = 1, // the frames of the description file, or every identifier, in order.
+        SimulateReplay = 2,   // the frames of a binary frame table export, at their recorded times.
+    } tLINSimulationTraffic;
+
+    typedef enum
+    {
+        ImpairNone = 0,  // ideal bit timing.
+        ImpairMild = 1,  // some drift, spacing and the odd glitch.
+        ImpairHarsh = 2, // everything at or past the limits of the specification.
+    } tLINSimulationImpairments;
+
     LINAnalyzerSettings();
     virtual ~LINAnalyzerSettings();
 
@@ -19,11 +62,35 @@ class LINAnalyzerSettings : public AnalyzerSettings
     Channel mInputChannel;
     double mLINVersion;
     U32 mBitRate;
+    tLINMarkerDensity mMarkerDensity;
+    tLINCommitPolicy mCommitPolicy;
+    U32 mCommitFrames;     // CommitBatched: most frames held back.
+    U32 mCommitIntervalMs; // CommitBatched: most capture time held back.
+    tLINFrameOutput mFrameOutput;
+    std::string mDescriptionFile; // LDF path, empty if none.
+    tLINSimulationTraffic mSimulationTraffic;
+    std::string mSimulationTraceFile; // SimulateReplay: the frame table to replay.
+    U32 mSimulationSeed;      // the same seed gives the same simulated waveform.
+    U32 mSimulationBusLoad;   // percent.
+    U32 mSimulationErrorRate; // frames with an error, per 1000.
+    tLINSimulationImpairments mSimulationImpairments;
 
   protected:
     std::auto_ptr<AnalyzerSettingInterfaceChannel> mInputChannelInterface;
     std::auto_ptr<AnalyzerSettingInterfaceNumberList> mLINVersionInterface;
     std::auto_ptr<AnalyzerSettingInterfaceInteger> mBitRateInterface;
+    std::auto_ptr<AnalyzerSettingInterfaceNumberList> mMarkerDensityInterface;
+    std::auto_ptr<AnalyzerSettingInterfaceNumberList> mCommitPolicyInterface;
+    std::auto_ptr<AnalyzerSettingInterfaceInteger> mCommitFramesInterface;
+    std::auto_ptr<AnalyzerSettingInterfaceInteger> mCommitIntervalMsInterface;
+    std::auto_ptr<AnalyzerSettingInterfaceNumberList> mFrameOutputInterface;
+    std::auto_ptr<AnalyzerSettingInterfaceText> mDescriptionFileInterface;
+    std::auto_ptr<AnalyzerSettingInterfaceNumberList> mSimulationTrafficInterface;
+    std::auto_ptr<AnalyzerSettingInterfaceText> mSimulationTraceFileInterface;
+    std::auto_ptr<AnalyzerSettingInterfaceInteger> mSimulationSeedInterface;
+    std::auto_ptr<AnalyzerSettingInterfaceInteger> mSimulationBusLoadInterface;
+    std::auto_ptr<AnalyzerSettingInterfaceInteger> mSimulationErrorRateInterface;
+    std::auto_ptr<AnalyzerSettingInterfaceNumberList> mSimulationImpairmentsInterface;
 };
 
 #endif // LIN_ANALYZER_SETTINGS
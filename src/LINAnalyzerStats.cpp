@@ -0,0 +1,45 @@
+#include "LINAnalyzerStats.h"
+#include "LINDecoder.h"
+
+namespace
+{
+    // FrameV2 keys and export names, indexed by LINAnalyzerStats::tLINCounter.
+    const char* const CounterNames[] = {
+        "fields", "edges", "advances", "markers", "frames", "packets", "commits", "framing_errors", "break_hunts", "resyncs",
+    };
+    static_assert( sizeof( CounterNames ) / sizeof( CounterNames[ 0 ] ) == LINAnalyzerStats::CounterCount,
+                   "every counter needs a name" );
+
+    // indexed by LINDecoder::tLINFrameState.
+    const char* const StateTimeNames[] = {
+        "time_no_frame", "time_header_break", "time_header_sync", "time_header_pid", "time_data_zero", "time_data", "time_checksum",
+    };
+    static_assert( sizeof( StateTimeNames ) / sizeof( StateTimeNames[ 0 ] ) == LINAnalyzerStats::StateCount,
+                   "every frame state needs a time name" );
+    static_assert( LINAnalyzerStats::StateCount == LINDecoder::responseChecksum + 1, "StateCount is out of date" );
+}
+
+LINAnalyzerStats::LINAnalyzerStats()
+{
+    Clear();
+}
+
+void LINAnalyzerStats::Clear()
+{
+    for( U32 i = 0; i < CounterCount; i++ )
+        mCounters[ i ] = 0;
+    for( U32 i = 0; i < StateCount; i++ )
+        mStateSeconds[ i ] = 0;
+    mRunStart = std::chrono::steady_clock::now();
+    mRandom = 0x2545F491; // any non-zero seed.
+}
+
+const char* LINAnalyzerStats::GetCounterName( tLINCounter counter )
+{
+    return CounterNames[ counter ];
+}
+
+const char* LINAnalyzerStats::GetStateTimeName( U32 state )
+{
+    return StateTimeNames[ state ];
+}
@@ -0,0 +1,78 @@
+#ifndef LIN_ANALYZER_STATS_H
+#define LIN_ANALYZER_STATS_H
+
+#include "LINTypes.h"
+#include <chrono>
+
+// decoder instrumentation, for working out why a decode is slow or wrong. Configure with -DLIN_ANALYZER_STATS=ON to build it
+// in; otherwise every LIN_STATS() statement compiles to nothing and the decoder carries no counters at all.
+#ifndef LIN_ANALYZER_STATS
+#define LIN_ANALYZER_STATS 0
+#endif
+
+#if LIN_ANALYZER_STATS
+#define LIN_STATS( statement ) statement
+#else
+#define LIN_STATS( statement )
+#endif
+
+struct LINAnalyzerStats
+{
+    typedef enum
+    {
+        Fields = 0,    // breaks and bytes read.
+        Edges,         // edges the channel was advanced to.
+        Advances,      // Advance() and AdvanceToAbsPosition() calls.
+        Markers,       // markers added.
+        Frames,        // byte and inter-byte space frames added.
+        Packets,       // LIN frames started by a break.
+        Commits,       // CommitResults() calls.
+        FramingErrors, // bytes without a stop bit.
+        BreakHunts,    // edges looked at by GetBreakField() while hunting for a break.
+        Resyncs,       // frames abandoned part way through to look for the next break.
+        CounterCount
+    } tLINCounter;
+
+    enum
+    {
+        StateCount = 7,     // LINDecoder::tLINFrameState.
+        TimingInterval = 64 // one field in this many, picked at random, is timed.
+    };
+
+    LINAnalyzerStats();
+    void Clear();
+
+    void Count( tLINCounter counter, U64 amount = 1 )
+    {
+        mCounters[ counter ] += amount;
+    }
+
+    // once per break or byte, with the edges and markers it took. Each field also parks the channel with one Advance.
+    void CountField( U64 edges, U64 markers )
+    {
+        ++mCounters[ Fields ];
+        mCounters[ Edges ] += edges;
+        mCounters[ Markers ] += markers;
+        ++mCounters[ Advances ];
+    }
+
+    // reading the clock around every field would cost more than decoding it. Fields are timed at random instead, and the
+    // time scaled up; a fixed interval could line up with the frame length and only ever time the same state.
+    bool TimeThisField()
+    {
+        mRandom ^= mRandom << 13;
+        mRandom ^= mRandom >> 17;
+        mRandom ^= mRandom << 5;
+        return ( mRandom % TimingInterval ) == 0;
+    }
+
+    static const char* GetCounterName( tLINCounter counter );
+    static const char* GetStateTimeName( U32 state );
+
+    U64 mCounters[ CounterCount ];
+    double mStateSeconds[ StateCount ]; // estimated decode time spent in each state.
+    std::chrono::steady_clock::time_point mRunStart;
+    U32 mRandom;
+};
+
+#endif // LIN_ANALYZER_STATS_H
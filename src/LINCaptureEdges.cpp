@@ -0,0 +1,220 @@
+#include "LINCaptureEdges.h"
+#include <string.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace
+{
+    const char ExportMagic[ 8 ] = { '<', 'S', 'A', 'L', 'E', 'A', 'E', '>' };
+
+    template <typename T> T Load( const U8* data )
+    {
+        T value;
+        memcpy( &value, data, sizeof( value ) );
+        return value;
+    }
+
+    U32 CountTrailingZeros( U64 value ) // `value` isn't 0.
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64( &index, value );
+        return U32( index );
+#else
+        return U32( __builtin_ctzll( value ) );
+#endif
+    }
+}
+
+LINTransitionTimes::LINTransitionTimes()
+    : mTimes( NULL ),
+      mEdgeCount( 0 ),
+      mBeginTime( 0.0 ),
+      mSampleRate( 0.0 ),
+      mEndSample( 0 ),
+      mSampleNumber( 0 ),
+      mNextEdge( 0 ),
+      mHigh( true )
+{
+}
+
+bool LINTransitionTimes::Open( const U8* data, U64 size, U64 sample_rate )
+{
+    if( size < HeaderSize || memcmp( data, ExportMagic, sizeof( ExportMagic ) ) != 0 )
+        return false;
+
+    const U32 version = Load<U32>( data + 8 );
+    const U32 type = Load<U32>( data + 12 );
+    if( version > 1 || type != 0 )
+        return false;
+
+    const U64 edge_count = Load<U64>( data + 36 );
+    if( edge_count > ( size - HeaderSize ) / sizeof( double ) )
+        return false;
+
+    mTimes = data + HeaderSize;
+    mEdgeCount = edge_count;
+    mBeginTime = Load<double>( data + 20 );
+    mSampleRate = double( sample_rate );
+    mSampleNumber = 0;
+    mNextEdge = 0;
+    mHigh = Load<U32>( data + 16 ) != 0;
+
+    const double end_time = Load<double>( data + 28 );
+    mEndSample = end_time > mBeginTime ? U64( ( end_time - mBeginTime ) * mSampleRate + 0.5 ) : 0;
+    if( mEdgeCount > 0 && mEndSample < GetEdge( mEdgeCount - 1 ) )
+        mEndSample = GetEdge( mEdgeCount - 1 );
+    return true;
+}
+
+U64 LINTransitionTimes::GetEdge( U64 index ) const
+{
+    const double offset = Load<double>( mTimes + index * sizeof( double ) ) - mBeginTime;
+    return offset > 0.0 ? U64( offset * mSampleRate + 0.5 ) : 0;
+}
+
+U64 LINTransitionTimes::GetSampleNumber()
+{
+    return mSampleNumber;
+}
+
+bool LINTransitionTimes::IsHigh()
+{
+    return mHigh;
+}
+
+void LINTransitionTimes::MoveTo( U64 sample_number )
+{
+    if( sample_number > mEndSample )
+        throw LINEdgeStreamEnd();
+
+    while( mNextEdge < mEdgeCount && GetEdge( mNextEdge ) <= sample_number )
+    {
+        ++mNextEdge;
+        mHigh = !mHigh;
+    }
+    mSampleNumber = sample_number;
+}
+
+void LINTransitionTimes::AdvanceToNextEdge()
+{
+    if( mNextEdge >= mEdgeCount )
+        throw LINEdgeStreamEnd();
+    MoveTo( GetEdge( mNextEdge ) );
+}
+
+void LINTransitionTimes::AdvanceToAbsPosition( U64 sample_number )
+{
+    if( sample_number > mSampleNumber )
+        MoveTo( sample_number );
+}
+
+U64 LINTransitionTimes::GetSampleOfNextEdge()
+{
+    if( mNextEdge >= mEdgeCount )
+        throw LINEdgeStreamEnd();
+    return GetEdge( mNextEdge );
+}
+
+bool LINTransitionTimes::WouldAdvancingToAbsPositionCauseTransition( U64 sample_number )
+{
+    return mNextEdge < mEdgeCount && GetEdge( mNextEdge ) <= sample_number;
+}
+
+LINSampleBits::LINSampleBits( const U8* data, U64 size )
+    : mData( data ),
+      mSize( size ),
+      mSampleCount( size * 8 ),
+      mSampleNumber( 0 ),
+      mNextEdge( UnknownEdge ),
+      mHigh( size > 0 && GetBit( 0 ) )
+{
+}
+
+bool LINSampleBits::GetBit( U64 sample_number ) const
+{
+    return ( mData[ sample_number >> 3 ] >> ( sample_number & 7 ) ) & 1;
+}
+
+// loads the up to 64 samples from `sample` on as one word, shifted so `sample` is bit 0. Bytes past the end read as low,
+// which only matters when looking for a low sample, so such an edge is clamped to the end.
+U64 LINSampleBits::FindEdge( U64 sample_number, bool high ) const
+{
+    while( sample_number < mSampleCount )
+    {
+        const U64 byte = sample_number >> 3;
+        const U32 shift = U32( sample_number & 7 );
+        const U64 available = mSize - byte;
+
+        U64 word = 0;
+        memcpy( &word, mData + byte, size_t( available < 8 ? available : 8 ) );
+        word >>= shift;
+
+        U64 differs = high ? ~word : word;
+        if( shift != 0 )
+            differs &= ~U64( 0 ) >> shift;
+        if( differs != 0 )
+        {
+            const U64 edge = sample_number + CountTrailingZeros( differs );
+            return edge < mSampleCount ? edge : mSampleCount;
+        }
+        sample_number += 64 - shift;
+    }
+    return mSampleCount;
+}
+
+U64 LINSampleBits::GetNextEdge()
+{
+    if( mNextEdge == UnknownEdge )
+        mNextEdge = FindEdge( mSampleNumber + 1, mHigh );
+    return mNextEdge;
+}
+
+U64 LINSampleBits::GetSampleNumber()
+{
+    return mSampleNumber;
+}
+
+bool LINSampleBits::IsHigh()
+{
+    return mHigh;
+}
+
+void LINSampleBits::AdvanceToNextEdge()
+{
+    const U64 edge = GetNextEdge();
+    if( edge >= mSampleCount )
+        throw LINEdgeStreamEnd();
+    mSampleNumber = edge;
+    mHigh = !mHigh;
+    mNextEdge = UnknownEdge;
+}
+
+void LINSampleBits::AdvanceToAbsPosition( U64 sample_number )
+{
+    if( sample_number <= mSampleNumber )
+        return;
+    if( sample_number >= mSampleCount )
+        throw LINEdgeStreamEnd();
+
+    mSampleNumber = sample_number;
+    mHigh = GetBit( sample_number );
+    if( mNextEdge != UnknownEdge && mNextEdge <= sample_number )
+        mNextEdge = UnknownEdge;
+}
+
+U64 LINSampleBits::GetSampleOfNextEdge()
+{
+    const U64 edge = GetNextEdge();
+    if( edge >= mSampleCount )
+        throw LINEdgeStreamEnd();
+    return edge;
+}
+
+bool LINSampleBits::WouldAdvancingToAbsPositionCauseTransition( U64 sample_number )
+{
+    const U64 edge = GetNextEdge();
+    return edge < mSampleCount && edge <= sample_number;
+}
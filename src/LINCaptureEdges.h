@@ -0,0 +1,75 @@
+#ifndef LIN_CAPTURE_EDGES_H
+#define LIN_CAPTURE_EDGES_H
+
+#include "LINEdgeSource.h"
+
+// edge sources over the raw capture files the batch decoder reads. Both read the file's bytes in place, typically from a
+// LINMappedFile, and keep nothing but their position. Multi-byte values are little endian, as on every host Logic runs on.
+
+// a Logic 2 binary export of one digital channel: "<SALEAE>", version, type 0, the initial state, the begin and end times
+// and the number of transitions, then the time of each transition in seconds as a double. Times are turned into sample
+// numbers at `sample_rate`, counted from the begin time, as they are read.
+class LINTransitionTimes : public LINEdgeSource
+{
+  public:
+    LINTransitionTimes();
+
+    bool Open( const U8* data, U64 size, U64 sample_rate ); // false if `data` isn't a digital export, or is cut short.
+
+    virtual U64 GetSampleNumber();
+    virtual bool IsHigh();
+
+    virtual void AdvanceToNextEdge();
+    virtual void AdvanceToAbsPosition( U64 sample_number );
+
+    virtual U64 GetSampleOfNextEdge();
+    virtual bool WouldAdvancingToAbsPositionCauseTransition( U64 sample_number );
+
+    static const U32 HeaderSize = 44;
+
+  protected:
+    U64 GetEdge( U64 index ) const;
+    void MoveTo( U64 sample_number );
+
+    const U8* mTimes;
+    U64 mEdgeCount;
+    double mBeginTime;
+    double mSampleRate;
+    U64 mEndSample;
+    U64 mSampleNumber;
+    U64 mNextEdge; // index of the first transition after mSampleNumber.
+    bool mHigh;
+};
+
+// one bit per sample, the first sample in the least significant bit of the first byte, with no header. Edges are found a
+// 64 bit word at a time, so long idle stretches cost a few loads each.
+class LINSampleBits : public LINEdgeSource
+{
+  public:
+    LINSampleBits( const U8* data, U64 size );
+
+    virtual U64 GetSampleNumber();
+    virtual bool IsHigh();
+
+    virtual void AdvanceToNextEdge();
+    virtual void AdvanceToAbsPosition( U64 sample_number );
+
+    virtual U64 GetSampleOfNextEdge();
+    virtual bool WouldAdvancingToAbsPositionCauseTransition( U64 sample_number );
+
+  protected:
+    bool GetBit( U64 sample_number ) const;
+    U64 FindEdge( U64 sample_number, bool high ) const; // the first sample from `sample_number` on that isn't `high`.
+    U64 GetNextEdge();                                 // mSampleCount if there's none.
+
+    const U8* mData;
+    U64 mSize;
+    U64 mSampleCount;
+    U64 mSampleNumber;
+    U64 mNextEdge; // cached; UnknownEdge until looked for.
+    bool mHigh;
+
+    static const U64 UnknownEdge = ~U64( 0 );
+};
+
+#endif // LIN_CAPTURE_EDGES_H
@@ -8,6 +8,11 @@ LINChecksum::~LINChecksum()
 {
 }
 
+bool LINChecksum::IsEnhanced( double lin_version, U8 identifier )
+{
+    return lin_version >= 2 && LINEnhancedChecksum::IncludesPID( identifier );
+}
+
 void LINChecksum::clear()
 {
     mChecksum = 0;
@@ -15,18 +20,13 @@ void LINChecksum::clear()
 
 U8 LINChecksum::add( U8 byte )
 {
+    // add the carry straight back in; the sum never exceeds 510 so a single fold is enough.
     mChecksum += byte;
-    if( mChecksum >= 256 )
-        mChecksum -= 255;
-
-    // if ( mChecksum & 0x100 ) // carry?
-    //	mChecksum += 1;
+    mChecksum = ( mChecksum & 0xFF ) + ( mChecksum >> 8 );
     return ( U8 )( mChecksum & 0xFF );
 }
 
-U8 LINChecksum::result()
+U8 LINChecksum::result() const
 {
-    U8 rc = ( U8 )( mChecksum & 0xFF );
-    rc = ~rc;
-    return rc;
+    return ( U8 )~mChecksum;
 }
@@ -0,0 +1,617 @@
+#include "LINDecoder.h"
+#include "LINProtectedIdentifier.h"
+
+namespace
+{
+    // fractional bits of LINDecoder::mBitPeriod. 16 keeps a break of millions of bits from overflowing at any sample rate.
+    const U32 BitPeriodFractionBits = 16;
+
+    // Samples bit cells from the run lengths between edges instead of advancing the source to every bit centre. The source only
+    // moves edge to edge, so the cost of a field scales with the transitions on the wire rather than with its bit count.
+    // `horizon` is the last centre that will be sampled; we never look for edges beyond it, so a quiet bus after the final byte
+    // of a capture doesn't stall the decode.
+    class EdgeRunSampler
+    {
+      public:
+        EdgeRunSampler( LINEdgeSource* source, U64 horizon )
+            : mSource( source ), mHorizon( horizon ), mHigh( source->IsHigh() ), mEdges( 0 )
+        {
+            FindNextEdge();
+        }
+
+        // centres must be requested in ascending order.
+        bool IsHighAt( U64 sample )
+        {
+            while( mNextEdge <= sample )
+            {
+                mSource->AdvanceToNextEdge();
+                LIN_STATS( ++mEdges );
+                mHigh = !mHigh;
+                FindNextEdge();
+            }
+            return mHigh;
+        }
+
+        // leaves the source parked on the horizon, exactly where per-bit advancing would have left it.
+        void Finish()
+        {
+            mSource->AdvanceToAbsPosition( mHorizon );
+        }
+
+        U32 GetEdges() const // only counted in LIN_ANALYZER_STATS builds.
+        {
+            return mEdges;
+        }
+
+      private:
+        void FindNextEdge()
+        {
+            if( mSource->WouldAdvancingToAbsPositionCauseTransition( mHorizon ) )
+                mNextEdge = mSource->GetSampleOfNextEdge();
+            else
+                mNextEdge = U64( -1 ); // no more edges in this field.
+        }
+
+        LINEdgeSource* mSource;
+        U64 mHorizon;
+        U64 mNextEdge;
+        bool mHigh;
+        U32 mEdges;
+    };
+}
+
+LINDecoder::Settings::Settings()
+    : mSampleRate( 0 ), mBitRate( 19200 ), mLINVersion( 2.0 ), mMarkBits( true ), mMarkStartStop( true )
+{
+}
+
+LINDecoder::LINDecoder() : mSource( NULL ), mSink( NULL ), mFrameState( NoFrame ), mInLINFrame( false )
+{
+}
+
+LINDecoder::~LINDecoder()
+{
+}
+
+void LINDecoder::Run( LINEdgeSource* source, LINDecoderSink* sink, const Settings& settings )
+{
+    try
+    {
+        Start( source, sink, settings );
+        for( ;; )
+            DecodeField();
+    }
+    catch( const LINEdgeStreamEnd& )
+    {
+    }
+    Flush();
+}
+
+void LINDecoder::Configure( const Settings& settings )
+{
+    mSettings = settings;
+    SetupBitTiming();
+
+    // an LDF that is missing or can't be parsed leaves the table empty, and every response length is guessed as before.
+    mDescription.Load( mSettings.mDescriptionFile.c_str() );
+}
+
+void LINDecoder::Start( LINEdgeSource* source, LINDecoderSink* sink, const Settings& settings )
+{
+    mSource = source;
+    mSink = sink;
+    Configure( settings );
+
+    mFrameState = NoFrame; // reset every time we run.
+    mShowIBS = false;
+    mDataBytes = 0;
+    LIN_STATS( mStats.Clear() );
+    mExpectedDataBytes = 0;
+
+    mAtFieldStart = false;
+    mFrameStartingSample = 0;
+    mInLINFrame = false;
+
+    if( !mSource->IsHigh() )
+    {
+        mSource->AdvanceToNextEdge();
+        LIN_STATS( mStats.Count( LINAnalyzerStats::Edges ) );
+    }
+    mField.mEndingSample = mSource->GetSampleNumber();
+}
+
+void LINDecoder::DecodeField()
+{
+    bool framing_error;
+    bool is_data_really_break = false;
+    bool ready_to_save = false;
+    bool is_start_of_packet = false;
+    Field& byteFrame = mField;
+
+    // a lookahead may have left us on the next field's start edge already; the space began where the last field ended.
+    const S64 ibs_start = mAtFieldStart ? byteFrame.mEndingSample : mSource->GetSampleNumber();
+    if( ( mFrameState == NoFrame ) || ( mFrameState == headerBreak ) )
+    {
+        byteFrame.mData = GetBreakField( byteFrame.mStartingSample, byteFrame.mEndingSample, framing_error );
+    }
+    else
+    {
+        byteFrame.mData = ByteFrame( byteFrame.mStartingSample, byteFrame.mEndingSample, framing_error, is_data_really_break );
+    }
+
+    byteFrame.mFlags = framing_error ? byteFramingError : 0;
+    byteFrame.mType = mFrameState;
+    LIN_STATS( if( framing_error ) mStats.Count( LINAnalyzerStats::FramingErrors ) );
+
+    if( is_data_really_break )
+    {
+        // here we reset.
+        LIN_STATS( mStats.Count( LINAnalyzerStats::Resyncs ) );
+        mFrameState = NoFrame;
+        mShowIBS = false;
+    }
+
+    if( mShowIBS )
+        mSink->OnInterByteSpace( ibs_start, byteFrame.mStartingSample );
+
+    switch( mFrameState )
+    {
+    case NoFrame:
+        mFrameState = headerBreak;
+        // fall through
+    case headerBreak: // expecting break
+        mShowIBS = true;
+        if( byteFrame.mData == 0x00 )
+        {
+            mFrameState = headerSync;
+            byteFrame.mType = headerBreak;
+            is_start_of_packet = true;
+            mFrameStartingSample = byteFrame.mStartingSample;
+            LIN_STATS( mStats.Count( LINAnalyzerStats::Packets ) );
+        }
+        else
+        {
+            byteFrame.mFlags |= headerBreakExpected;
+            LIN_STATS( mStats.Count( LINAnalyzerStats::Resyncs ) );
+            mFrameState = NoFrame;
+        }
+        break;
+    case headerSync: // expecting sync.
+        if( byteFrame.mData == 0x55 )
+        {
+            mFrameState = headerPID;
+        }
+        else
+        {
+            byteFrame.mFlags |= headerSyncExpected;
+            LIN_STATS( mStats.Count( LINAnalyzerStats::Resyncs ) );
+            mFrameState = NoFrame;
+        }
+        break;
+    case headerPID: // expecting PID.
+    {
+        // a corrupt header says nothing about the response that follows; close the frame and look for the next break.
+        if( !LINValidPIDs[ byteFrame.mData ] )
+        {
+            byteFrame.mFlags |= pidParityError;
+            LIN_STATS( mStats.Count( LINAnalyzerStats::Resyncs ) );
+            mFrameState = NoFrame;
+            ready_to_save = true;
+            break;
+        }
+        mFrameState = responseDataZero;
+
+        U8 identifier = byteFrame.mData & 0x3F;
+
+        // with an LDF loaded, the response length of a described frame is known up front. 0 means guess it from the checksum.
+        const LINDescriptionFile::FrameInfo* frame_info = mDescription.GetFrame( identifier );
+        mExpectedDataBytes = frame_info != NULL ? frame_info->mLength : 0;
+
+        mChecksum.clear();
+        if( UsesEnhancedChecksum( identifier ) )
+        {
+            mChecksum.add( byteFrame.mData ); // We only add the PID byte to the checksum IF we're using version 2 AND we're not using
+                                              // one of the classic identifers.
+        }
+    }
+    break;
+    // LIN Response
+    case responseDataZero: // expecting first resppnse data byte.
+        mChecksum.add( byteFrame.mData );
+        mDataBytes = 1;
+        mFrameState = responseData;
+        break;
+    case responseData: // expecting response data.
+    {
+        // without an LDF length, a byte matching the checksum ends the response only if no further data byte follows it.
+        bool response_ends;
+        if( mExpectedDataBytes != 0 )
+            response_ends = mDataBytes >= mExpectedDataBytes;
+        else
+            response_ends = mDataBytes >= 8 || ( mChecksum.result() == byteFrame.mData && ResponseEndsHere( mDataBytes ) );
+
+        if( !response_ends )
+        {
+            ++mDataBytes;
+            mChecksum.add( byteFrame.mData );
+            break;
+        }
+        mFrameState = responseChecksum;
+        byteFrame.mType = responseChecksum;
+        ready_to_save = true;
+    }
+    // the byte that ends the response is the checksum.
+    // fall through
+    case responseChecksum: // expecting checksum.
+
+        if( mChecksum.result() != byteFrame.mData )
+        {
+            byteFrame.mFlags |= checksumMismatch;
+        }
+        mFrameState = NoFrame;
+        mShowIBS = false;
+        mDataBytes = 0;
+        break;
+    }
+
+    byteFrame.mDataBytes = mDataBytes;
+    byteFrame.mStartsPacket = is_start_of_packet;
+    byteFrame.mEndsPacket = ready_to_save;
+
+    mSink->OnField( byteFrame );
+    TrackLINFrame( byteFrame );
+}
+
+void LINDecoder::Flush()
+{
+    if( mInLINFrame )
+        ReportLINFrame();
+    mInLINFrame = false;
+}
+
+LINDecoder::tLINFrameState LINDecoder::GetFrameState() const
+{
+    return mFrameState;
+}
+
+void LINDecoder::TrackLINFrame( const Field& field )
+{
+    if( field.mStartsPacket )
+    {
+        if( mInLINFrame )
+            ReportLINFrame();
+        mInLINFrame = true;
+    }
+
+    if( !mInLINFrame )
+        return; // noise before the first break.
+
+    AddToLINFrame( mLINFrame, field );
+
+    if( field.mEndsPacket )
+    {
+        ReportLINFrame();
+        mInLINFrame = false;
+    }
+}
+
+void LINDecoder::ReportLINFrame()
+{
+    CheckLINFrame( mLINFrame, mLINFrame.mHasPID && UsesEnhancedChecksum( mLINFrame.mPID & 0x3F ) );
+    mSink->OnLINFrame( mLINFrame );
+}
+
+void LINDecoder::AddToLINFrame( LINFrame& lin_frame, const Field& field )
+{
+    if( field.mStartsPacket )
+    {
+        lin_frame.mHasPID = false;
+        lin_frame.mPID = 0;
+        lin_frame.mFlags = 0;
+        lin_frame.mResponseLength = 0;
+        lin_frame.mStartingSample = field.mStartingSample;
+        lin_frame.mHeaderEndingSample = field.mEndingSample;
+    }
+
+    // checksum errors are worked out again once the whole response is known.
+    lin_frame.mFlags |= field.mFlags & ~checksumMismatch;
+    lin_frame.mEndingSample = field.mEndingSample;
+
+    switch( static_cast<tLINFrameState>( field.mType ) )
+    {
+    case headerBreak:
+    case headerSync:
+        lin_frame.mHeaderEndingSample = field.mEndingSample;
+        break;
+    case headerPID:
+        lin_frame.mHasPID = true;
+        lin_frame.mPID = field.mData;
+        lin_frame.mHeaderEndingSample = field.mEndingSample;
+        break;
+    case responseDataZero:
+    case responseData:
+    case responseChecksum:
+        if( lin_frame.mResponseLength == 0 )
+            lin_frame.mResponseStartingSample = field.mStartingSample;
+        if( lin_frame.mResponseLength < sizeof( lin_frame.mResponse ) )
+            lin_frame.mResponse[ lin_frame.mResponseLength++ ] = field.mData;
+        break;
+    default:
+        break;
+    }
+}
+
+void LINDecoder::CheckLINFrame( LINFrame& lin_frame, bool enhanced_checksum )
+{
+    lin_frame.mEnhancedChecksum = enhanced_checksum;
+
+    // the last byte of the response is the checksum; everything before it is data.
+    if( lin_frame.mResponseLength > 0 )
+    {
+        U8 data_length = lin_frame.mResponseLength - 1;
+        U8 expected = enhanced_checksum ? LINEnhancedChecksumEngine::Compute( lin_frame.mPID, lin_frame.mResponse, data_length )
+                                        : LINClassicChecksumEngine::Compute( lin_frame.mPID, lin_frame.mResponse, data_length );
+        if( expected != lin_frame.mResponse[ data_length ] )
+            lin_frame.mFlags |= checksumMismatch;
+    }
+}
+
+bool LINDecoder::UsesEnhancedChecksum( U8 identifier ) const
+{
+    const LINDescriptionFile::FrameInfo* frame_info = mDescription.GetFrame( identifier );
+    if( frame_info != NULL )
+        return frame_info->mEnhancedChecksum;
+
+    return LINChecksum::IsEnhanced( mSettings.mLINVersion, identifier );
+}
+
+const LINDescriptionFile& LINDecoder::GetDescription() const
+{
+    return mDescription;
+}
+
+#if LIN_ANALYZER_STATS
+LINAnalyzerStats& LINDecoder::GetStats()
+{
+    return mStats;
+}
+
+const LINAnalyzerStats& LINDecoder::GetStats() const
+{
+    return mStats;
+}
+#endif
+
+void LINDecoder::SetupBitTiming()
+{
+    mBitPeriod = ( ( U64( mSettings.mSampleRate ) << BitPeriodFractionBits ) + mSettings.mBitRate / 2 ) / mSettings.mBitRate;
+    mHalfBit = U32( SamplesInHalfBits( 1 ) );
+
+    for( U32 i = 0; i < 10; i++ )
+        mByteBitCenters[ i ] = U32( SamplesInHalfBits( 2 * i + 1 ) );
+}
+
+// every position is computed from the start of the field rather than accumulated bit by bit, so rounding never drifts.
+U64 LINDecoder::SamplesInHalfBits( U64 half_bits ) const
+{
+    return ( half_bits * mBitPeriod + ( U64( 1 ) << BitPeriodFractionBits ) ) >> ( BitPeriodFractionBits + 1 );
+}
+
+U32 LINDecoder::BitsInRun( U64 samples ) const
+{
+    return U32( ( ( samples << BitPeriodFractionBits ) + mBitPeriod / 2 ) / mBitPeriod );
+}
+
+// called on the stop bit of a byte that matches the checksum. It is the checksum unless another data byte follows, so look at
+// the next field: the response is over if the bus stays idle past the point where a longer response would have to continue,
+// or if the next field stays low through a stop bit, i.e. it's a break. In the second case the source is left on the field's
+// start edge, and the next ByteFrame() or GetBreakField() picks up from there.
+bool LINDecoder::ResponseEndsHere( U32 data_bytes )
+{
+    if( !mSource->IsHigh() )
+        return false;
+
+    // a response of one more data byte must start its checksum byte by 1.4 times its nominal frame time (34 bits of header
+    // and response space, 10 per byte) after the break. Wait at least a byte time regardless, for masters that run late.
+    const U64 half_bits_allowed = ( 14 * ( 34 + 10 * ( data_bytes + 2 ) ) ) / 5 - 20;
+    const U64 deadline = mFrameStartingSample + SamplesInHalfBits( half_bits_allowed );
+    const U64 now = mSource->GetSampleNumber();
+    U64 idle_samples = SamplesInHalfBits( 20 );
+    if( deadline > now + idle_samples )
+        idle_samples = deadline - now;
+
+    if( !mSource->WouldAdvancingToAbsPositionCauseTransition( now + idle_samples ) )
+        return true;
+
+    mSource->AdvanceToNextEdge();
+    LIN_STATS( mStats.Count( LINAnalyzerStats::Edges ) );
+    mAtFieldStart = true;
+
+    // a data byte is high again by its stop bit.
+    return !mSource->WouldAdvancingToAbsPositionCauseTransition( mSource->GetSampleNumber() + mByteBitCenters[ 9 ] );
+}
+
+void LINDecoder::AdvanceHalfBit()
+{
+    LIN_STATS( mStats.Count( LINAnalyzerStats::Advances ) );
+    mSource->AdvanceToAbsPosition( mSource->GetSampleNumber() + mHalfBit );
+}
+
+U8 LINDecoder::GetBreakField( S64& startingSample, S64& endingSample, bool& framingError )
+{
+    // locate the start bit (falling edge expected)...
+    U32 min_break_field_low_bits =
+        13; // as per the spec of LIN. at least 13 bits at master speed, but receiver only needs it to be 11 or more.
+    U32 num_break_bits = 0;
+    bool valid_fame = false;
+    LIN_STATS( U64 edges = 0 );
+    LIN_STATS( U64 markers = 0 );
+    for( ;; )
+    {
+        if( mAtFieldStart )
+        {
+            mAtFieldStart = false;
+        }
+        else
+        {
+            mSource->AdvanceToNextEdge();
+            LIN_STATS( ++edges );
+            if( mSource->IsHigh() )
+            {
+                mSource->AdvanceToNextEdge();
+                LIN_STATS( ++edges );
+            }
+        }
+        LIN_STATS( mStats.Count( LINAnalyzerStats::BreakHunts ) );
+        num_break_bits = BitsInRun( mSource->GetSampleOfNextEdge() - mSource->GetSampleNumber() );
+        if( num_break_bits >= min_break_field_low_bits )
+        {
+            startingSample = mSource->GetSampleNumber();
+            valid_fame = true;
+            break;
+        }
+    }
+
+    const U64 break_start = startingSample;
+    const U64 stop_center = break_start + SamplesInHalfBits( 2 * num_break_bits + 1 );
+    EdgeRunSampler sampler( mSource, stop_center );
+
+    // the break bits are only sampled to be marked; nothing else depends on them.
+    if( mSettings.mMarkBits )
+    {
+        for( U32 i = 0; i < num_break_bits; i++ )
+        {
+            U64 center = break_start + SamplesInHalfBits( 2 * i + 1 );
+            // let's put a dot exactly where we sample this bit:
+            mSink->OnMarker( center, sampler.IsHighAt( center ) ? OneMarker : ZeroMarker );
+        }
+        LIN_STATS( markers += num_break_bits );
+    }
+
+    // Validate the stop bit...
+    if( sampler.IsHighAt( stop_center ) )
+    {
+        if( mSettings.mMarkStartStop )
+            mSink->OnMarker( stop_center, StopMarker );
+        LIN_STATS( markers += mSettings.mMarkStartStop );
+        framingError = false;
+    }
+    else
+    {
+        mSink->OnMarker( stop_center, ErrorSquareMarker );
+        LIN_STATS( ++markers );
+        framingError = true;
+    }
+    sampler.Finish();
+    LIN_STATS( mStats.CountField( edges + sampler.GetEdges(), markers ) );
+
+    endingSample = stop_center;
+
+    return ( valid_fame ) ? 0 : 1;
+}
+
+U8 LINDecoder::ByteFrame( S64& startingSample, S64& endingSample, bool& framingError, bool& is_break_field )
+{
+    U8 data = 0;
+
+    framingError = false;
+    is_break_field = false;
+    LIN_STATS( U64 edges = 0 );
+    LIN_STATS( U64 markers = 0 );
+
+    // locate the start bit (falling edge expected)...
+    if( mAtFieldStart )
+    {
+        mAtFieldStart = false;
+    }
+    else
+    {
+        mSource->AdvanceToNextEdge();
+        LIN_STATS( ++edges );
+        if( mSource->IsHigh() )
+        {
+            AdvanceHalfBit();
+            mSink->OnMarker( mSource->GetSampleNumber(), ErrorDotMarker );
+            mSource->AdvanceToNextEdge();
+            LIN_STATS( ++edges );
+            LIN_STATS( ++markers );
+        }
+    }
+    startingSample = mSource->GetSampleNumber();
+
+    // bit centres are absolute offsets from the start bit edge.
+    const U64 byte_start = startingSample;
+    const U64 stop_center = byte_start + mByteBitCenters[ 9 ];
+    EdgeRunSampler sampler( mSource, stop_center );
+
+    if( mSettings.mMarkStartStop )
+        mSink->OnMarker( byte_start + mByteBitCenters[ 0 ], StartMarker );
+    LIN_STATS( markers += mSettings.mMarkStartStop + 8 * mSettings.mMarkBits ); // the start and data bit markers.
+
+    // mark each data bit (LSB first)...
+    if( mSettings.mMarkBits )
+    {
+        for( U32 i = 0; i < 8; i++ )
+        {
+            U64 center = byte_start + mByteBitCenters[ i + 1 ];
+            bool high = sampler.IsHighAt( center );
+
+            if( high )
+                data |= 1 << i;
+
+            // let's put a dot exactly where we sample this bit:
+            mSink->OnMarker( center, high ? OneMarker : ZeroMarker );
+        }
+    }
+    else
+    {
+        for( U32 i = 0; i < 8; i++ )
+        {
+            if( sampler.IsHighAt( byte_start + mByteBitCenters[ i + 1 ] ) )
+                data |= 1 << i;
+        }
+    }
+
+    // Validate the stop bit...
+    bool stop_high = sampler.IsHighAt( stop_center );
+    sampler.Finish();
+    LIN_STATS( edges += sampler.GetEdges() );
+    if( stop_high )
+    {
+        if( mSettings.mMarkStartStop )
+            mSink->OnMarker( stop_center, StopMarker );
+        LIN_STATS( markers += mSettings.mMarkStartStop );
+    }
+    else
+    {
+        // check to see if we're really in a break frame...
+        // we should be dead center in the stop bit here. (10 bits in, exactly)
+        // a break frame has at least 13 bits low, however the slave is only required to measure 11 bits low.
+        // there is no maximum limit to the length of the break frame.
+
+        // checks the remaining 3 bits to make sure they are high.
+        bool all_13_clear = !mSource->WouldAdvancingToAbsPositionCauseTransition( mSource->GetSampleNumber() + SamplesInHalfBits( 6 ) );
+
+        mSource->AdvanceToNextEdge(); // we're high again, and at the end of the break frame!
+        LIN_STATS( ++edges );
+        // verify that we've found a stop bit. If there are no transitions, it's high in the center of the bit field.
+        bool high_bit_present = !mSource->WouldAdvancingToAbsPositionCauseTransition( mSource->GetSampleNumber() + mHalfBit );
+
+        if( all_13_clear && high_bit_present )
+        {
+            endingSample = mSource->GetSampleNumber();
+            is_break_field = true;
+            LIN_STATS( mStats.CountField( edges, markers ) );
+            return 0x00;
+        }
+
+        mSink->OnMarker( mSource->GetSampleNumber(), ErrorSquareMarker );
+        LIN_STATS( ++markers );
+        framingError = true;
+    }
+
+    endingSample = mSource->GetSampleNumber();
+    LIN_STATS( mStats.CountField( edges, markers ) );
+
+    return data;
+}
@@ -0,0 +1,179 @@
+#ifndef LIN_DECODER_H
+#define LIN_DECODER_H
+
+#include "LINTypes.h"
+#include "LINAnalyzerStats.h"
+#include "LINChecksum.h"
+#include "LINDescriptionFile.h"
+#include "LINEdgeSource.h"
+#include <string>
+
+class LINDecoderSink;
+
+// the LIN protocol decoder: finds the breaks, reads bytes off the bit timing, and follows each frame from its header through
+// the response, checking the sync byte, PID parity and checksum. It reads a LINEdgeSource and reports to a LINDecoderSink,
+// and doesn't depend on the AnalyzerSDK; LINAnalyzer is the adapter that runs it in Logic.
+class LINDecoder
+{
+  public:
+    typedef enum
+    {
+        NoFrame = 0, // no frame recognized.
+        // LIN Header
+        headerBreak, // expecting break.
+        headerSync,  // expecting sync.
+        headerPID,   // expecting PID.
+        // LIN Response
+        responseDataZero, // expecting first data byte.
+        responseData,     // expecting response data.
+        responseChecksum  // expecting checksum.
+    } tLINFrameState;
+
+    typedef enum
+    {
+        Okay = 0x00,
+        byteFramingError = 0x01,
+        headerBreakExpected = 0x02,
+        headerSyncExpected = 0x04,
+        checksumMismatch = 0x08,
+        pidParityError = 0x10,
+    } tLINFrameFlags;
+
+    typedef enum
+    {
+        StartMarker = 0,
+        StopMarker,
+        OneMarker,
+        ZeroMarker,
+        ErrorDotMarker,
+        ErrorSquareMarker,
+        MarkerCount
+    } tLINMarker;
+
+    struct Settings
+    {
+        Settings();
+
+        U32 mSampleRate;
+        U32 mBitRate;
+        double mLINVersion;
+        std::string mDescriptionFile; // LDF path, empty if none.
+        bool mMarkBits;               // a marker on every bit, not just on errors.
+        bool mMarkStartStop;          // and on the start and stop bits.
+    };
+
+    // a break or a byte, and its place in the frame.
+    struct Field
+    {
+        S64 mStartingSample;
+        S64 mEndingSample;
+        U8 mType;      // tLINFrameState.
+        U8 mData;      // 0 for a break.
+        U8 mDataBytes; // response data bytes so far, counting this one.
+        U8 mFlags;     // tLINFrameFlags.
+        bool mStartsPacket; // a break.
+        bool mEndsPacket;   // the checksum, or a header the response can't follow.
+    };
+
+    // a whole LIN frame, from its break to its checksum, or to the last byte before the next break.
+    struct LINFrame
+    {
+        bool mHasPID;
+        U8 mPID;
+        U8 mFlags;          // tLINFrameFlags of the whole frame, with the checksum worked out again from the response.
+        U8 mResponseLength; // response bytes received, including the checksum.
+        U8 mResponse[ 9 ];
+        bool mEnhancedChecksum;
+        S64 mStartingSample;
+        S64 mHeaderEndingSample;
+        S64 mResponseStartingSample;
+        S64 mEndingSample;
+    };
+
+    LINDecoder();
+    ~LINDecoder();
+
+    // decodes the whole of `source`, until it throws LINEdgeStreamEnd.
+    void Run( LINEdgeSource* source, LINDecoderSink* sink, const Settings& settings );
+
+    // the steps of Run(), for callers that do their own work between fields. Start() sets up a run and skips to the first
+    // idle level; each DecodeField() reads one break or byte; Flush() reports the LIN frame still in progress.
+    void Start( LINEdgeSource* source, LINDecoderSink* sink, const Settings& settings );
+    void DecodeField();
+    void Flush();
+
+    // the two steps that put a LINFrame together, for callers rebuilding one from fields kept earlier. AddToLINFrame() takes
+    // the fields in order, starting afresh at a break; CheckLINFrame() then checks the checksum with the given model.
+    static void AddToLINFrame( LINFrame& lin_frame, const Field& field );
+    static void CheckLINFrame( LINFrame& lin_frame, bool enhanced_checksum );
+
+    // takes the settings and loads the LDF without decoding anything, so UsesEnhancedChecksum() can be asked about frames
+    // recorded earlier. Start() does this itself.
+    void Configure( const Settings& settings );
+
+    tLINFrameState GetFrameState() const;
+    bool UsesEnhancedChecksum( U8 identifier ) const;
+    const LINDescriptionFile& GetDescription() const;
+
+#if LIN_ANALYZER_STATS
+    LINAnalyzerStats& GetStats(); // the caller counts its own frames and commits here too.
+    const LINAnalyzerStats& GetStats() const;
+#endif
+
+  protected:
+    U8 ByteFrame( S64& startingSample, S64& endingSample, bool& framingError, bool& is_break_field );
+    U8 GetBreakField( S64& startingSample, S64& endingSample, bool& framingError );
+    void SetupBitTiming();
+    U64 SamplesInHalfBits( U64 half_bits ) const;
+    U32 BitsInRun( U64 samples ) const;
+
+    void AdvanceHalfBit();
+    bool ResponseEndsHere( U32 data_bytes );
+
+    void TrackLINFrame( const Field& field );
+    void ReportLINFrame();
+
+  protected: // vars
+    LINEdgeSource* mSource;
+    LINDecoderSink* mSink;
+    Settings mSettings;
+
+    tLINFrameState mFrameState;
+    Field mField;             // the field last read.
+    bool mShowIBS;            // report the inter-byte space before the next field?
+    U8 mDataBytes;            // response data bytes read so far.
+    LINChecksum mChecksum;
+    LINDescriptionFile mDescription;
+    U8 mExpectedDataBytes;    // response length of the current frame from the LDF, 0 if unknown.
+    S64 mFrameStartingSample; // start of the current frame's break.
+    bool mAtFieldStart;       // the source is already on the start edge of the next field, see ResponseEndsHere().
+
+    // bit timing, fixed once per run by SetupBitTiming().
+    U64 mBitPeriod;            // samples per bit, fixed point.
+    U32 mHalfBit;              // samples in half a bit, rounded.
+    U32 mByteBitCenters[ 10 ]; // start, data and stop bit centres, as offsets from the start bit edge.
+
+    LINFrame mLINFrame; // the frame being assembled.
+    bool mInLINFrame;
+
+#if LIN_ANALYZER_STATS
+    LINAnalyzerStats mStats;
+#endif
+};
+
+// where LINDecoder's results go. Fields and their markers are reported as they are read, each field after the inter-byte
+// space before it; a LIN frame once it ends or the next break starts.
+class LINDecoderSink
+{
+  public:
+    virtual ~LINDecoderSink()
+    {
+    }
+
+    virtual void OnMarker( U64 sample, LINDecoder::tLINMarker marker ) = 0;
+    virtual void OnInterByteSpace( S64 starting_sample, S64 ending_sample ) = 0;
+    virtual void OnField( const LINDecoder::Field& field ) = 0;
+    virtual void OnLINFrame( const LINDecoder::LINFrame& lin_frame ) = 0;
+};
+
+#endif // LIN_DECODER_H
@@ -0,0 +1,325 @@
+#include "LINDescriptionFile.h"
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdlib.h>
+#include <string.h>
+
+namespace
+{
+    const U8 NoPublisher = 0xFF;
+
+    const char WordDelimiters[] = " \t\r\n{};:,=\"";
+
+    // splits an LDF into words, numbers, strings (without their quotes) and single character punctuation, dropping comments.
+    bool Tokenize( const std::string& text, std::vector<std::string>& tokens )
+    {
+        size_t i = 0;
+        const size_t n = text.size();
+        while( i < n )
+        {
+            char c = text[ i ];
+            if( c == ' ' || c == '\t' || c == '\r' || c == '\n' )
+            {
+                ++i;
+            }
+            else if( c == '/' && i + 1 < n && text[ i + 1 ] == '/' )
+            {
+                while( i < n && text[ i ] != '\n' )
+                    ++i;
+            }
+            else if( c == '/' && i + 1 < n && text[ i + 1 ] == '*' )
+            {
+                size_t end = text.find( "*/", i + 2 );
+                if( end == std::string::npos )
+                    return false;
+                i = end + 2;
+            }
+            else if( c == '"' )
+            {
+                size_t end = text.find( '"', i + 1 );
+                if( end == std::string::npos )
+                    return false;
+                tokens.push_back( text.substr( i + 1, end - i - 1 ) );
+                i = end + 1;
+            }
+            else if( c == '{' || c == '}' || c == ';' || c == ':' || c == ',' || c == '=' )
+            {
+                tokens.push_back( std::string( 1, c ) );
+                ++i;
+            }
+            else
+            {
+                size_t start = i;
+                while( i < n && memchr( WordDelimiters, text[ i ], sizeof( WordDelimiters ) - 1 ) == NULL &&
+                       !( text[ i ] == '/' && i + 1 < n && ( text[ i + 1 ] == '/' || text[ i + 1 ] == '*' ) ) )
+                    ++i;
+                tokens.push_back( text.substr( start, i - start ) );
+            }
+        }
+        return true;
+    }
+
+    bool ParseInteger( const std::string& token, long& value )
+    {
+        if( token.empty() )
+            return false;
+        char* end = NULL;
+        if( token.size() > 2 && token[ 0 ] == '0' && ( token[ 1 ] == 'x' || token[ 1 ] == 'X' ) )
+            value = strtol( token.c_str() + 2, &end, 16 );
+        else
+            value = strtol( token.c_str(), &end, 10 );
+        return *end == 0;
+    }
+
+    // steps over a { ... } block, including any nested blocks. `i` is on the opening brace.
+    bool SkipBlock( const std::vector<std::string>& tokens, size_t& i )
+    {
+        U32 depth = 0;
+        for( ; i < tokens.size(); ++i )
+        {
+            if( tokens[ i ] == "{" )
+                ++depth;
+            else if( tokens[ i ] == "}" && --depth == 0 )
+            {
+                ++i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool Expect( const std::vector<std::string>& tokens, size_t& i, const char* token )
+    {
+        if( i >= tokens.size() || tokens[ i ] != token )
+            return false;
+        ++i;
+        return true;
+    }
+
+    struct FrameDefinition
+    {
+        long mIdentifier;
+        long mLength;
+        std::string mPublisher;
+    };
+}
+
+LINDescriptionFile::LINDescriptionFile()
+{
+    Clear();
+}
+
+LINDescriptionFile::~LINDescriptionFile()
+{
+}
+
+void LINDescriptionFile::Clear()
+{
+    for( U32 i = 0; i < 64; i++ )
+    {
+        mFrames[ i ].mLength = 0;
+        mFrames[ i ].mEnhancedChecksum = false;
+        mFrames[ i ].mPublisher = NoPublisher;
+    }
+    mNodes.clear();
+    mEmpty = true;
+}
+
+bool LINDescriptionFile::IsEmpty() const
+{
+    return mEmpty;
+}
+
+const LINDescriptionFile::FrameInfo* LINDescriptionFile::GetFrame( U8 identifier ) const
+{
+    if( identifier >= 64 || mFrames[ identifier ].mLength == 0 )
+        return NULL;
+    return &mFrames[ identifier ];
+}
+
+const char* LINDescriptionFile::GetNodeName( U8 index ) const
+{
+    if( index >= mNodes.size() )
+        return NULL;
+    return mNodes[ index ].c_str();
+}
+
+U8 LINDescriptionFile::AddNode( const std::string& name )
+{
+    for( size_t i = 0; i < mNodes.size(); i++ )
+    {
+        if( mNodes[ i ] == name )
+            return U8( i );
+    }
+    if( mNodes.size() >= NoPublisher )
+        return NoPublisher;
+    mNodes.push_back( name );
+    return U8( mNodes.size() - 1 );
+}
+
+bool LINDescriptionFile::Load( const char* path )
+{
+    Clear();
+    if( path == NULL || *path == 0 )
+        return false;
+
+    std::ifstream file_stream( path, std::ios::in | std::ios::binary );
+    if( !file_stream )
+        return false;
+    std::stringstream text;
+    text << file_stream.rdbuf();
+
+    return Parse( text.str() );
+}
+
+bool LINDescriptionFile::Parse( const std::string& text )
+{
+    Clear();
+
+    std::vector<std::string> tokens;
+    if( !Tokenize( text, tokens ) || tokens.empty() || tokens[ 0 ] != "LIN_description_file" )
+        return false;
+
+    double cluster_protocol = 2.0;
+    std::string master;
+    std::map<std::string, double> node_protocols;
+    std::vector<FrameDefinition> frames;
+
+    size_t i = 1;
+    while( i < tokens.size() )
+    {
+        const std::string& section = tokens[ i ];
+        if( section == ";" )
+        {
+            ++i;
+        }
+        else if( i + 1 < tokens.size() && tokens[ i + 1 ] == "=" )
+        {
+            // cluster wide attribute: name = value ;
+            if( section == "LIN_protocol_version" && i + 2 < tokens.size() )
+                cluster_protocol = atof( tokens[ i + 2 ].c_str() );
+            while( i < tokens.size() && tokens[ i ] != ";" )
+                ++i;
+        }
+        else if( i + 1 < tokens.size() && tokens[ i + 1 ] == "{" )
+        {
+            size_t block = i + 1;
+            size_t end = block;
+            if( !SkipBlock( tokens, end ) )
+                return false;
+            i = block + 1;
+
+            if( section == "Nodes" )
+            {
+                // Master : name , time_base , jitter ; Slaves : name , name ... ;
+                while( i < end - 1 )
+                {
+                    const std::string& kind = tokens[ i++ ];
+                    if( !Expect( tokens, i, ":" ) )
+                        return false;
+                    bool first = true;
+                    while( i < end - 1 && tokens[ i ] != ";" )
+                    {
+                        if( tokens[ i ] != "," && ( kind == "Slaves" || first ) )
+                        {
+                            if( kind == "Master" )
+                                master = tokens[ i ];
+                            AddNode( tokens[ i ] );
+                            first = false;
+                        }
+                        ++i;
+                    }
+                    ++i;
+                }
+            }
+            else if( section == "Frames" || section == "Diagnostic_frames" )
+            {
+                // name : id , publisher , length { signals }. Every token is read before the section's closing brace, so
+                // a frame cut short fails rather than running on into the next section.
+                const size_t close = end - 1;
+                while( i < close )
+                {
+                    FrameDefinition frame;
+                    ++i; // frame name
+                    if( !Expect( tokens, i, ":" ) || i >= close || !ParseInteger( tokens[ i++ ], frame.mIdentifier ) )
+                        return false;
+                    frame.mLength = 0;
+                    if( i < close && tokens[ i ] == "," )
+                    {
+                        if( ++i >= close )
+                            return false;
+                        frame.mPublisher = tokens[ i++ ];
+                        if( i < close && tokens[ i ] == "," )
+                        {
+                            if( ++i >= close || !ParseInteger( tokens[ i ], frame.mLength ) )
+                                return false;
+                            ++i;
+                        }
+                    }
+                    if( i >= close || tokens[ i ] != "{" || !SkipBlock( tokens, i ) )
+                        return false;
+
+                    if( section == "Diagnostic_frames" )
+                    {
+                        frame.mLength = 8;
+                        frame.mPublisher = frame.mIdentifier == 0x3C ? master : std::string();
+                    }
+                    else if( frame.mLength == 0 )
+                    {
+                        // LIN 1.x: the length is encoded in the identifier.
+                        frame.mLength = frame.mIdentifier < 32 ? 2 : ( frame.mIdentifier < 48 ? 4 : 8 );
+                    }
+                    if( frame.mIdentifier < 0 || frame.mIdentifier > 0x3F || frame.mLength < 1 || frame.mLength > 8 )
+                        return false;
+                    frames.push_back( frame );
+                }
+            }
+            else if( section == "Node_attributes" )
+            {
+                // node { LIN_protocol = "2.1" ; ... }
+                while( i < end - 1 )
+                {
+                    const std::string& node = tokens[ i++ ];
+                    size_t node_end = i;
+                    if( i >= end || tokens[ i ] != "{" || !SkipBlock( tokens, node_end ) )
+                        return false;
+                    for( ; i + 2 < node_end; ++i )
+                    {
+                        if( tokens[ i ] == "LIN_protocol" && tokens[ i + 1 ] == "=" )
+                            node_protocols[ node ] = atof( tokens[ i + 2 ].c_str() );
+                    }
+                    i = node_end;
+                }
+            }
+
+            i = end;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    if( frames.empty() )
+        return false;
+
+    for( size_t f = 0; f < frames.size(); f++ )
+    {
+        const FrameDefinition& frame = frames[ f ];
+        FrameInfo& info = mFrames[ frame.mIdentifier ];
+
+        // the enhanced checksum is used by LIN 2.x publishers for everything but the diagnostic frames.
+        double protocol = cluster_protocol;
+        std::map<std::string, double>::const_iterator node = node_protocols.find( frame.mPublisher );
+        if( frame.mPublisher != master && node != node_protocols.end() )
+            protocol = node->second;
+
+        info.mLength = U8( frame.mLength );
+        info.mEnhancedChecksum = frame.mIdentifier < 0x3C && protocol >= 2.0;
+        info.mPublisher = frame.mPublisher.empty() ? NoPublisher : AddNode( frame.mPublisher );
+    }
+
+    mEmpty = false;
+    return true;
+}
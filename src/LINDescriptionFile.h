@@ -0,0 +1,40 @@
+#ifndef LIN_DESCRIPTION_FILE_H
+#define LIN_DESCRIPTION_FILE_H
+
+#include "LINTypes.h"
+#include <string>
+#include <vector>
+
+// The parts of a LIN Description File (LDF) the decoder needs: for each frame identifier, how many data bytes the response
+// carries, which checksum model protects it, and which node publishes it.
+class LINDescriptionFile
+{
+  public:
+    struct FrameInfo
+    {
+        U8 mLength;             // data bytes in the response, 1-8. 0 if the identifier isn't described.
+        bool mEnhancedChecksum; // LIN 2.x checksum, including the PID.
+        U8 mPublisher;          // index for GetNodeName().
+    };
+
+    LINDescriptionFile();
+    ~LINDescriptionFile();
+
+    // returns false, and leaves the table empty, if the file can't be read or isn't a valid LDF.
+    bool Load( const char* path );
+    bool Parse( const std::string& text );
+    void Clear();
+
+    bool IsEmpty() const;
+    const FrameInfo* GetFrame( U8 identifier ) const; // NULL if the identifier isn't described.
+    const char* GetNodeName( U8 index ) const;
+
+  protected:
+    U8 AddNode( const std::string& name );
+
+    FrameInfo mFrames[ 64 ];
+    std::vector<std::string> mNodes;
+    bool mEmpty;
+};
+
+#endif // LIN_DESCRIPTION_FILE_H
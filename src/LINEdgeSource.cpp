@@ -0,0 +1,54 @@
+#include "LINEdgeSource.h"
+
+LINEdgeList::LINEdgeList( bool initial_high, const U64* edges, U64 edge_count, U64 end_sample )
+    : mEdges( edges ), mEdgeCount( edge_count ), mEndSample( end_sample ), mSampleNumber( 0 ), mNextEdge( 0 ), mHigh( initial_high )
+{
+}
+
+U64 LINEdgeList::GetSampleNumber()
+{
+    return mSampleNumber;
+}
+
+bool LINEdgeList::IsHigh()
+{
+    return mHigh;
+}
+
+void LINEdgeList::MoveTo( U64 sample_number )
+{
+    if( sample_number > mEndSample )
+        throw LINEdgeStreamEnd();
+
+    while( mNextEdge < mEdgeCount && mEdges[ mNextEdge ] <= sample_number )
+    {
+        ++mNextEdge;
+        mHigh = !mHigh;
+    }
+    mSampleNumber = sample_number;
+}
+
+void LINEdgeList::AdvanceToNextEdge()
+{
+    if( mNextEdge >= mEdgeCount )
+        throw LINEdgeStreamEnd();
+    MoveTo( mEdges[ mNextEdge ] );
+}
+
+void LINEdgeList::AdvanceToAbsPosition( U64 sample_number )
+{
+    if( sample_number > mSampleNumber )
+        MoveTo( sample_number );
+}
+
+U64 LINEdgeList::GetSampleOfNextEdge()
+{
+    if( mNextEdge >= mEdgeCount )
+        throw LINEdgeStreamEnd();
+    return mEdges[ mNextEdge ];
+}
+
+bool LINEdgeList::WouldAdvancingToAbsPositionCauseTransition( U64 sample_number )
+{
+    return mNextEdge < mEdgeCount && mEdges[ mNextEdge ] <= sample_number;
+}
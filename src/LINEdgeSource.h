@@ -0,0 +1,57 @@
+#ifndef LIN_EDGE_SOURCE_H
+#define LIN_EDGE_SOURCE_H
+
+#include "LINTypes.h"
+
+// thrown by a source that has no more data. It ends LINDecoder::Run().
+struct LINEdgeStreamEnd
+{
+};
+
+// the decoder's view of the bus: one channel, read forward from edge to edge. LINAnalyzer adapts AnalyzerChannelData to
+// it; LINEdgeList reads a list of edges instead, to decode without the SDK.
+class LINEdgeSource
+{
+  public:
+    virtual ~LINEdgeSource()
+    {
+    }
+
+    virtual U64 GetSampleNumber() = 0;
+    virtual bool IsHigh() = 0;
+
+    virtual void AdvanceToNextEdge() = 0;
+    virtual void AdvanceToAbsPosition( U64 sample_number ) = 0; // no further than the current position if it's behind.
+
+    virtual U64 GetSampleOfNextEdge() = 0;
+    virtual bool WouldAdvancingToAbsPositionCauseTransition( U64 sample_number ) = 0; // an edge at or before `sample_number`?
+};
+
+// an edge list in memory, for batch decoding. `edges` holds the sample numbers at which the line toggles, in ascending
+// order, and isn't copied. Reading past the last edge, or past `end_sample`, throws LINEdgeStreamEnd.
+class LINEdgeList : public LINEdgeSource
+{
+  public:
+    LINEdgeList( bool initial_high, const U64* edges, U64 edge_count, U64 end_sample );
+
+    virtual U64 GetSampleNumber();
+    virtual bool IsHigh();
+
+    virtual void AdvanceToNextEdge();
+    virtual void AdvanceToAbsPosition( U64 sample_number );
+
+    virtual U64 GetSampleOfNextEdge();
+    virtual bool WouldAdvancingToAbsPositionCauseTransition( U64 sample_number );
+
+  protected:
+    void MoveTo( U64 sample_number );
+
+    const U64* mEdges;
+    U64 mEdgeCount;
+    U64 mEndSample;
+    U64 mSampleNumber;
+    U64 mNextEdge; // index of the first edge after mSampleNumber.
+    bool mHigh;
+};
+
+#endif // LIN_EDGE_SOURCE_H
@@ -0,0 +1,38 @@
+#ifndef LIN_FRAME_TABLE_H
+#define LIN_FRAME_TABLE_H
+
+#include "LINTypes.h"
+
+// layout of the "binary LIN frame table" export, see README.md. All values are little endian. LINFrameTableWriter writes it,
+// for the analyzer's export and the batch decoder, and LINFrameTableReader reads it back to replay it.
+const char LINFrameTableMagic[ 8 ] = { 'L', 'I', 'N', 'F', 'R', 'A', 'M', 'E' };
+const U32 LINFrameTableVersion = 1;
+const U32 LINFrameTableHeaderSize = 96;
+const U32 LINFrameTableIndexEntries = 65; // IDs 0-63, then frames whose header ended before the PID.
+const U8 LINFrameTableNoID = 0xFF;
+const U64 LINFrameTableMaxRecords = 0xFFFFFFFF; // the index lists number records in 32 bits.
+const U8 LINFrameTableNoChecksum = 0x80; // record flag: no response was received, so there is no checksum byte.
+
+enum
+{
+    LINFrameTableTimestampColumn = 0,
+    LINFrameTableIdColumn,
+    LINFrameTableLengthColumn,
+    LINFrameTableDataColumn,
+    LINFrameTableChecksumColumn,
+    LINFrameTableFlagsColumn,
+    LINFrameTableColumnCount
+};
+const U32 LINFrameTableColumnWidths[ LINFrameTableColumnCount ] = { 8, 1, 1, 8, 1, 1 };
+
+struct LINFrameTableRecord
+{
+    U64 mTimestamp; // sample number of the start of the break.
+    U8 mIdentifier; // LINFrameTableNoID if the header ended before the PID.
+    U8 mLength;     // data bytes, 0-8.
+    U8 mData[ 8 ];  // zero past mLength.
+    U8 mChecksum;
+    U8 mFlags; // LINDecoder::tLINFrameFlags, and LINFrameTableNoChecksum.
+};
+
+#endif // LIN_FRAME_TABLE_H
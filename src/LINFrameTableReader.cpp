@@ -0,0 +1,168 @@
+#include "LINFrameTableReader.h"
+#include "LINChecksum.h"
+#include "LINProtectedIdentifier.h"
+#include <string.h>
+
+namespace
+{
+    U64 GetLittleEndian( const U8* source, U32 bytes )
+    {
+        U64 value = 0;
+        for( U32 i = 0; i < bytes; i++ )
+            value |= U64( source[ i ] ) << ( 8 * i );
+        return value;
+    }
+}
+
+LINFrameTableReader::LINFrameTableReader()
+{
+    Close();
+}
+
+LINFrameTableReader::~LINFrameTableReader()
+{
+}
+
+bool LINFrameTableReader::Open( const char* path )
+{
+    Close();
+    if( path == NULL || *path == 0 )
+        return false;
+
+    mFile.open( path, std::ios::in | std::ios::binary );
+    U8 header[ LINFrameTableHeaderSize ];
+    if( !mFile || !mFile.read( reinterpret_cast<char*>( header ), sizeof( header ) ) ||
+        memcmp( header, LINFrameTableMagic, sizeof( LINFrameTableMagic ) ) != 0 ||
+        GetLittleEndian( &header[ 8 ], 4 ) != LINFrameTableVersion || GetLittleEndian( &header[ 12 ], 4 ) < LINFrameTableHeaderSize )
+    {
+        Close();
+        return false;
+    }
+
+    mRecordCount = GetLittleEndian( &header[ 16 ], 8 );
+    mSampleRate = GetLittleEndian( &header[ 24 ], 8 );
+    for( U32 column = 0; column < LINFrameTableColumnCount; column++ )
+        mColumnOffsets[ column ] = GetLittleEndian( &header[ 48 + column * 8 ], 8 );
+    if( mSampleRate == 0 || mRecordCount > LINFrameTableMaxRecords )
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void LINFrameTableReader::Close()
+{
+    if( mFile.is_open() )
+        mFile.close();
+    mFile.clear();
+    mRecordCount = 0;
+    mSampleRate = 0;
+    for( U32 column = 0; column < LINFrameTableColumnCount; column++ )
+    {
+        mColumnOffsets[ column ] = 0;
+        mColumns[ column ].clear();
+    }
+    mBlockStart = 0;
+    mNextRecord = 0;
+}
+
+bool LINFrameTableReader::Next( Record& record )
+{
+    if( mNextRecord >= mRecordCount )
+        return false;
+
+    if( ( mNextRecord == mBlockStart + BlockRecords || mColumns[ 0 ].empty() ) && !ReadBlock() )
+        return false;
+
+    const U64 i = mNextRecord - mBlockStart;
+    record.mTimestamp = GetLittleEndian( &mColumns[ LINFrameTableTimestampColumn ][ i * 8 ], 8 );
+    record.mIdentifier = mColumns[ LINFrameTableIdColumn ][ i ];
+    record.mLength = mColumns[ LINFrameTableLengthColumn ][ i ];
+    if( record.mLength > 8 )
+        record.mLength = 8;
+    memcpy( record.mData, &mColumns[ LINFrameTableDataColumn ][ i * 8 ], 8 );
+    record.mChecksum = mColumns[ LINFrameTableChecksumColumn ][ i ];
+    record.mFlags = mColumns[ LINFrameTableFlagsColumn ][ i ];
+    ++mNextRecord;
+    return true;
+}
+
+U64 LINFrameTableReader::VerifyChecksums( const bool* enhanced_ids, U64& checked )
+{
+    // each block's frames are split by checksum model into columns the batch engine can run down without branching.
+    std::vector<U8> pids[ 2 ];
+    std::vector<U8> data[ 2 ];
+    std::vector<U8> checksums[ 2 ];
+    for( U32 model = 0; model < 2; model++ )
+    {
+        pids[ model ].resize( BlockRecords );
+        data[ model ].resize( BlockRecords * 8 );
+        checksums[ model ].resize( BlockRecords );
+    }
+    std::vector<U8> mismatches( BlockRecords );
+    U64 mismatch_count = 0;
+    checked = 0;
+
+    while( mNextRecord < mRecordCount )
+    {
+        if( ( mNextRecord == mBlockStart + BlockRecords || mColumns[ 0 ].empty() ) && !ReadBlock() )
+            break;
+
+        U32 count[ 2 ] = { 0, 0 };
+        const U64 block_end = mBlockStart + mColumns[ LINFrameTableIdColumn ].size();
+        for( U64 i = mNextRecord - mBlockStart; i < block_end - mBlockStart; i++ )
+        {
+            const U8 identifier = mColumns[ LINFrameTableIdColumn ][ i ];
+            if( identifier == LINFrameTableNoID || ( mColumns[ LINFrameTableFlagsColumn ][ i ] & LINFrameTableNoChecksum ) != 0 )
+                continue;
+
+            const U32 model = enhanced_ids[ identifier & 0x3F ] ? 1 : 0;
+            const U32 n = count[ model ]++;
+            pids[ model ][ n ] = LINProtectedIdentifier( identifier & 0x3F );
+            memcpy( &data[ model ][ n * 8 ], &mColumns[ LINFrameTableDataColumn ][ i * 8 ], 8 );
+            checksums[ model ][ n ] = mColumns[ LINFrameTableChecksumColumn ][ i ];
+        }
+        mismatch_count +=
+            LINClassicChecksumEngine::Verify( &pids[ 0 ][ 0 ], &data[ 0 ][ 0 ], &checksums[ 0 ][ 0 ], count[ 0 ], &mismatches[ 0 ] );
+        mismatch_count +=
+            LINEnhancedChecksumEngine::Verify( &pids[ 1 ][ 0 ], &data[ 1 ][ 0 ], &checksums[ 1 ][ 0 ], count[ 1 ], &mismatches[ 0 ] );
+        checked += count[ 0 ] + count[ 1 ];
+        mNextRecord = block_end;
+    }
+    return mismatch_count;
+}
+
+// the columns are in different parts of the file; each is read a block of records at a time.
+bool LINFrameTableReader::ReadBlock()
+{
+    mBlockStart = mNextRecord;
+    for( U32 column = 0; column < LINFrameTableColumnCount; column++ )
+    {
+        if( !ReadColumn( column ) )
+        {
+            mRecordCount = mNextRecord; // a truncated file ends here.
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LINFrameTableReader::ReadColumn( U32 column )
+{
+    const U64 width = LINFrameTableColumnWidths[ column ];
+    const U64 records = mRecordCount - mBlockStart < BlockRecords ? mRecordCount - mBlockStart : BlockRecords;
+    mColumns[ column ].resize( size_t( records * width ) );
+    mFile.seekg( std::streamoff( mColumnOffsets[ column ] + mBlockStart * width ) );
+    return bool( mFile.read( reinterpret_cast<char*>( &mColumns[ column ][ 0 ] ), std::streamsize( records * width ) ) );
+}
+
+U64 LINFrameTableReader::GetRecordCount() const
+{
+    return mRecordCount;
+}
+
+U64 LINFrameTableReader::GetSampleRate() const
+{
+    return mSampleRate;
+}
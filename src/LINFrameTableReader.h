@@ -0,0 +1,49 @@
+#ifndef LIN_FRAME_TABLE_READER_H
+#define LIN_FRAME_TABLE_READER_H
+
+#include "LINTypes.h"
+#include <fstream>
+#include <vector>
+
+#include "LINFrameTable.h"
+
+// reads the records of a binary LIN frame table export back in capture order. The columns are read a block at a time, so
+// memory use doesn't grow with the size of the file.
+class LINFrameTableReader
+{
+  public:
+    typedef LINFrameTableRecord Record;
+
+    LINFrameTableReader();
+    ~LINFrameTableReader();
+
+    // returns false, and reads nothing, if the file can't be read or isn't a frame table.
+    bool Open( const char* path );
+    void Close();
+
+    bool Next( Record& record ); // false at the end of the table.
+
+    // reads the rest of the table and checks every recorded checksum again, a block at a time, with the batch checksum
+    // engine. `enhanced_ids` gives the checksum model of each of the 64 IDs. Frames without an ID or a checksum are left
+    // out. Returns the number of checksums that don't match; `checked` is set to the number checked.
+    U64 VerifyChecksums( const bool* enhanced_ids, U64& checked );
+
+    U64 GetRecordCount() const;
+    U64 GetSampleRate() const;
+
+  protected:
+    bool ReadBlock();
+    bool ReadColumn( U32 column );
+
+    static const U64 BlockRecords = 4096;
+
+    std::ifstream mFile;
+    U64 mRecordCount;
+    U64 mSampleRate;
+    U64 mColumnOffsets[ LINFrameTableColumnCount ];
+    std::vector<U8> mColumns[ LINFrameTableColumnCount ]; // the current block of each column.
+    U64 mBlockStart;                                      // record number of the first record in the blocks.
+    U64 mNextRecord;
+};
+
+#endif // LIN_FRAME_TABLE_READER_H
@@ -0,0 +1,151 @@
+#include "LINFrameTableWriter.h"
+#include <string.h>
+
+namespace
+{
+    void PutLittleEndian( U8* dest, U64 value, U32 bytes )
+    {
+        for( U32 i = 0; i < bytes; i++ )
+            dest[ i ] = U8( value >> ( 8 * i ) );
+    }
+}
+
+LINFrameTableWriter::ColumnWriter::ColumnWriter() : mStream( NULL ), mOffset( 0 ), mWidth( 0 ), mUsed( 0 )
+{
+}
+
+void LINFrameTableWriter::ColumnWriter::Open( std::ofstream* stream, U64 offset, U32 width, U32 block_size )
+{
+    mStream = stream;
+    mOffset = offset;
+    mWidth = width;
+    mBuffer.resize( block_size - block_size % width );
+    mUsed = 0;
+}
+
+U8* LINFrameTableWriter::ColumnWriter::Add()
+{
+    if( mUsed == mBuffer.size() )
+        Flush();
+    U8* value = &mBuffer[ mUsed ];
+    mUsed += mWidth;
+    return value;
+}
+
+void LINFrameTableWriter::ColumnWriter::Flush()
+{
+    if( mUsed == 0 )
+        return;
+    mStream->seekp( std::streamoff( mOffset ) );
+    mStream->write( reinterpret_cast<const char*>( &mBuffer[ 0 ] ), std::streamsize( mUsed ) );
+    mOffset += mUsed;
+    mUsed = 0;
+}
+
+LINFrameTableWriter::LINFrameTableWriter() : mNextRecord( 0 )
+{
+}
+
+LINFrameTableWriter::~LINFrameTableWriter()
+{
+    if( mFile.is_open() )
+        Close();
+}
+
+bool LINFrameTableWriter::Open( const char* path, U64 sample_rate, U64 trigger_sample, const U64* id_counts )
+{
+    // the index lists hold u32 record numbers.
+    U64 records = 0;
+    for( U32 id = 0; id < LINFrameTableIndexEntries; id++ )
+        records += id_counts[ id ];
+    if( records > LINFrameTableMaxRecords )
+        return false;
+
+    mFile.open( path, std::ios::out | std::ios::binary | std::ios::trunc );
+    if( !mFile )
+        return false;
+
+    U64 column_offsets[ LINFrameTableColumnCount ];
+    U64 offset = LINFrameTableHeaderSize;
+    for( U32 column = 0; column < LINFrameTableColumnCount; column++ )
+    {
+        column_offsets[ column ] = offset;
+        mColumns[ column ].Open( &mFile, offset, LINFrameTableColumnWidths[ column ], 1 << 16 );
+        offset = ( offset + records * LINFrameTableColumnWidths[ column ] + 7 ) & ~U64( 7 );
+    }
+
+    const U64 index_offset = offset;
+    U8 index[ LINFrameTableIndexEntries * 16 ];
+    offset += sizeof( index );
+    for( U32 id = 0; id < LINFrameTableIndexEntries; id++ )
+    {
+        PutLittleEndian( &index[ id * 16 ], offset, 8 );
+        PutLittleEndian( &index[ id * 16 + 8 ], id_counts[ id ], 8 );
+        mIDLists[ id ].Open( &mFile, offset, 4, 1 << 12 );
+        offset += id_counts[ id ] * 4;
+    }
+
+    U8 header[ LINFrameTableHeaderSize ];
+    memset( header, 0, sizeof( header ) );
+    memcpy( header, LINFrameTableMagic, sizeof( LINFrameTableMagic ) );
+    PutLittleEndian( &header[ 8 ], LINFrameTableVersion, 4 );
+    PutLittleEndian( &header[ 12 ], LINFrameTableHeaderSize, 4 );
+    PutLittleEndian( &header[ 16 ], records, 8 );
+    PutLittleEndian( &header[ 24 ], sample_rate, 8 );
+    PutLittleEndian( &header[ 32 ], trigger_sample, 8 );
+    PutLittleEndian( &header[ 40 ], index_offset, 8 );
+    for( U32 column = 0; column < LINFrameTableColumnCount; column++ )
+        PutLittleEndian( &header[ 48 + column * 8 ], column_offsets[ column ], 8 );
+
+    mFile.write( reinterpret_cast<const char*>( header ), sizeof( header ) );
+    mFile.seekp( std::streamoff( index_offset ) );
+    mFile.write( reinterpret_cast<const char*>( index ), sizeof( index ) );
+    mNextRecord = 0;
+    return bool( mFile );
+}
+
+void LINFrameTableWriter::Add( const LINFrameTableRecord& record )
+{
+    PutLittleEndian( mColumns[ LINFrameTableTimestampColumn ].Add(), record.mTimestamp, 8 );
+    *mColumns[ LINFrameTableIdColumn ].Add() = record.mIdentifier;
+    *mColumns[ LINFrameTableLengthColumn ].Add() = record.mLength;
+    memcpy( mColumns[ LINFrameTableDataColumn ].Add(), record.mData, 8 );
+    *mColumns[ LINFrameTableChecksumColumn ].Add() = record.mChecksum;
+    *mColumns[ LINFrameTableFlagsColumn ].Add() = record.mFlags;
+    PutLittleEndian( mIDLists[ GetIndexEntry( record.mIdentifier ) ].Add(), mNextRecord, 4 );
+    ++mNextRecord;
+}
+
+bool LINFrameTableWriter::Close()
+{
+    for( U32 column = 0; column < LINFrameTableColumnCount; column++ )
+        mColumns[ column ].Flush();
+    for( U32 id = 0; id < LINFrameTableIndexEntries; id++ )
+        mIDLists[ id ].Flush();
+
+    bool written = bool( mFile );
+    mFile.close();
+    return written && bool( mFile );
+}
+
+U32 LINFrameTableWriter::GetIndexEntry( U8 identifier )
+{
+    return identifier == LINFrameTableNoID ? LINFrameTableIndexEntries - 1 : identifier & 0x3F;
+}
+
+void LINFrameTableWriter::MakeRecord( const LINDecoder::LINFrame& lin_frame, LINFrameTableRecord& record )
+{
+    memset( &record, 0, sizeof( record ) );
+    record.mTimestamp = U64( lin_frame.mStartingSample );
+    record.mIdentifier = lin_frame.mHasPID ? ( lin_frame.mPID & 0x3F ) : LINFrameTableNoID;
+    record.mFlags = lin_frame.mFlags;
+    if( lin_frame.mResponseLength == 0 )
+    {
+        record.mFlags |= LINFrameTableNoChecksum;
+        return;
+    }
+
+    record.mLength = U8( lin_frame.mResponseLength - 1 ); // mResponse holds at most 8 data bytes and the checksum.
+    memcpy( record.mData, lin_frame.mResponse, record.mLength );
+    record.mChecksum = lin_frame.mResponse[ record.mLength ];
+}
@@ -0,0 +1,56 @@
+#ifndef LIN_FRAME_TABLE_WRITER_H
+#define LIN_FRAME_TABLE_WRITER_H
+
+#include "LINTypes.h"
+#include <fstream>
+#include <vector>
+
+#include "LINDecoder.h"
+#include "LINFrameTable.h"
+
+// writes a binary LIN frame table. The number of frames of each ID fixes where every column and index list starts, so Open()
+// needs those counts up front. Add() then fills each column and list in at its own place in the file, a block at a time.
+class LINFrameTableWriter
+{
+  public:
+    LINFrameTableWriter();
+    ~LINFrameTableWriter();
+
+    // `id_counts` holds LINFrameTableIndexEntries counts: one per ID 0-63, then frames without an ID. The records must add up
+    // to them. Returns false if the file can't be created, or if they add up to more than LINFrameTableMaxRecords.
+    bool Open( const char* path, U64 sample_rate, U64 trigger_sample, const U64* id_counts );
+    void Add( const LINFrameTableRecord& record ); // in capture order.
+    bool Close();                                  // false if any of the file failed to write.
+
+    static U32 GetIndexEntry( U8 identifier ); // where a record's ID is counted in `id_counts`.
+
+    // the record of a LIN frame as the decoder reports it: the last byte of the response is the checksum, the bytes before
+    // it are the data, and a frame without a response is marked LINFrameTableNoChecksum.
+    static void MakeRecord( const LINDecoder::LINFrame& lin_frame, LINFrameTableRecord& record );
+
+  protected:
+    // one column of fixed width values, or one index list, and the block of it not yet written.
+    class ColumnWriter
+    {
+      public:
+        ColumnWriter();
+
+        void Open( std::ofstream* stream, U64 offset, U32 width, U32 block_size );
+        U8* Add(); // space for the next value.
+        void Flush();
+
+      private:
+        std::ofstream* mStream;
+        U64 mOffset; // file position of the next block.
+        U32 mWidth;
+        std::vector<U8> mBuffer;
+        size_t mUsed;
+    };
+
+    std::ofstream mFile;
+    ColumnWriter mColumns[ LINFrameTableColumnCount ];
+    ColumnWriter mIDLists[ LINFrameTableIndexEntries ];
+    U32 mNextRecord;
+};
+
+#endif // LIN_FRAME_TABLE_WRITER_H
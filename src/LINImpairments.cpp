@@ -0,0 +1,53 @@
+#include "LINImpairments.h"
+#include "LINAnalyzerSettings.h"
+
+LINImpairments::LINImpairments()
+{
+    Clear();
+}
+
+void LINImpairments::Clear()
+{
+    mClockDrift = 0;
+    mInterByteSpace = 0;
+    mResponseSpace = 0;
+    mGlitchRate = 0;
+    mGlitchWidth = 0;
+    mShortBreak = 0;
+    mLongBreak = 0;
+}
+
+void LINImpairments::Build( const LINAnalyzerSettings& settings )
+{
+    Clear();
+    switch( settings.mSimulationImpairments )
+    {
+    case LINAnalyzerSettings::ImpairMild:
+        // a healthy bus: the spread of a few slaves' oscillators, and the odd spike.
+        mClockDrift = 20;
+        mInterByteSpace = 1000;
+        mResponseSpace = 4000;
+        mGlitchRate = 1;
+        mGlitchWidth = 50;
+        mLongBreak = 2;
+        break;
+    case LINAnalyzerSettings::ImpairHarsh:
+        // everything at the limits of the specification, and beyond for the breaks and glitches.
+        mClockDrift = 140;
+        mInterByteSpace = 4000;
+        mResponseSpace = 10000;
+        mGlitchRate = 20;
+        mGlitchWidth = 200;
+        mShortBreak = 4;
+        mLongBreak = 4;
+        break;
+    default:
+        break;
+    }
+}
+
+bool LINImpairments::IsEmpty() const
+{
+    return mClockDrift == 0 && mInterByteSpace == 0 && mResponseSpace == 0 && mGlitchRate == 0 && mShortBreak == 0 &&
+           mLongBreak == 0;
+}
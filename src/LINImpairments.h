@@ -0,0 +1,27 @@
+#ifndef LIN_IMPAIRMENTS_H
+#define LIN_IMPAIRMENTS_H
+
+#include <LogicPublicTypes.h>
+
+class LINAnalyzerSettings;
+
+// how far the simulated bus is from ideal square waves. Times are in thousandths of a nominal bit. Each frame, byte, edge
+// or break picks its own impairment at random, up to these limits.
+struct LINImpairments
+{
+    LINImpairments();
+
+    void Clear(); // an ideal bus.
+    void Build( const LINAnalyzerSettings& settings );
+    bool IsEmpty() const;
+
+    U32 mClockDrift;     // per mille a slave's bit time can be off nominal, for a whole response. At most 140, LIN's 14%.
+    U32 mInterByteSpace; // longest extra space before a byte.
+    U32 mResponseSpace;  // longest extra delay between the PID and the response.
+    U32 mGlitchRate;     // glitches per 1000 runs of one level.
+    U32 mGlitchWidth;    // widest glitch.
+    U32 mShortBreak;     // most bits a break is shorter than 13. A master in spec never sends one.
+    U32 mLongBreak;      // most bits a break is longer than 13.
+};
+
+#endif // LIN_IMPAIRMENTS_H
@@ -0,0 +1,107 @@
+#include "LINMappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+LINMappedFile::LINMappedFile() : mData( NULL ), mSize( 0 )
+{
+}
+
+LINMappedFile::~LINMappedFile()
+{
+    Close();
+}
+
+// the mapping keeps its own reference to the file, so the handles are closed as soon as the view exists. The file is read
+// front to back, so the OS is told to read ahead and drop pages behind.
+bool LINMappedFile::Open( const char* path )
+{
+    Close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA( path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+    if( file == INVALID_HANDLE_VALUE )
+        return false;
+
+    LARGE_INTEGER size;
+    if( !GetFileSizeEx( file, &size ) )
+    {
+        CloseHandle( file );
+        return false;
+    }
+    if( size.QuadPart == 0 )
+    {
+        CloseHandle( file );
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA( file, NULL, PAGE_READONLY, 0, 0, NULL );
+    CloseHandle( file );
+    if( mapping == NULL )
+        return false;
+
+    void* view = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+    CloseHandle( mapping );
+    if( view == NULL )
+        return false;
+
+    mData = static_cast<const U8*>( view );
+    mSize = U64( size.QuadPart );
+#else
+    int file = open( path, O_RDONLY );
+    if( file < 0 )
+        return false;
+
+    struct stat status;
+    if( fstat( file, &status ) != 0 )
+    {
+        close( file );
+        return false;
+    }
+    if( status.st_size == 0 )
+    {
+        close( file );
+        return true;
+    }
+
+    void* view = mmap( NULL, size_t( status.st_size ), PROT_READ, MAP_PRIVATE, file, 0 );
+    close( file );
+    if( view == MAP_FAILED )
+        return false;
+    madvise( view, size_t( status.st_size ), MADV_SEQUENTIAL );
+
+    mData = static_cast<const U8*>( view );
+    mSize = U64( status.st_size );
+#endif
+    return true;
+}
+
+void LINMappedFile::Close()
+{
+    if( mData != NULL )
+    {
+#ifdef _WIN32
+        UnmapViewOfFile( mData );
+#else
+        munmap( const_cast<U8*>( mData ), size_t( mSize ) );
+#endif
+    }
+    mData = NULL;
+    mSize = 0;
+}
+
+const U8* LINMappedFile::GetData() const
+{
+    return mData;
+}
+
+U64 LINMappedFile::GetSize() const
+{
+    return mSize;
+}
@@ -0,0 +1,27 @@
+#ifndef LIN_MAPPED_FILE_H
+#define LIN_MAPPED_FILE_H
+
+#include "LINTypes.h"
+
+// a file mapped read only into memory, so a capture of any size is decoded in place rather than read into buffers.
+class LINMappedFile
+{
+  public:
+    LINMappedFile();
+    ~LINMappedFile();
+
+    bool Open( const char* path ); // false if the file can't be opened or mapped. An empty file opens with no data.
+    void Close();
+
+    const U8* GetData() const;
+    U64 GetSize() const;
+
+  private:
+    LINMappedFile( const LINMappedFile& ) = delete;
+    LINMappedFile& operator=( const LINMappedFile& ) = delete;
+
+    const U8* mData;
+    U64 mSize;
+};
+
+#endif // LIN_MAPPED_FILE_H
@@ -0,0 +1,52 @@
+#ifndef LIN_PROTECTED_IDENTIFIER_H
+#define LIN_PROTECTED_IDENTIFIER_H
+
+#include "LINTypes.h"
+
+// the protected identifier (PID) is the 6 bit frame identifier with two parity bits above it:
+// P0 = ID0 ^ ID1 ^ ID2 ^ ID4 and P1 = ~( ID1 ^ ID3 ^ ID4 ^ ID5 ).
+constexpr U8 LINIdentifierBit( U8 identifier, U32 bit )
+{
+    return ( identifier >> bit ) & 1;
+}
+
+constexpr U8 LINParityBits( U8 identifier )
+{
+    return U8( ( LINIdentifierBit( identifier, 0 ) ^ LINIdentifierBit( identifier, 1 ) ^ LINIdentifierBit( identifier, 2 ) ^
+                 LINIdentifierBit( identifier, 4 ) ) |
+               ( ( 1 ^ LINIdentifierBit( identifier, 1 ) ^ LINIdentifierBit( identifier, 3 ) ^ LINIdentifierBit( identifier, 4 ) ^
+                   LINIdentifierBit( identifier, 5 ) )
+                 << 1 ) );
+}
+
+constexpr U8 LINProtectedIdentifier( U8 identifier )
+{
+    return U8( ( identifier & 0x3F ) | ( LINParityBits( identifier & 0x3F ) << 6 ) );
+}
+
+constexpr bool LINIsValidPID( U8 pid )
+{
+    return LINProtectedIdentifier( pid & 0x3F ) == pid;
+}
+
+static_assert( LINProtectedIdentifier( 0x00 ) == 0x80, "LIN PID parity" );
+static_assert( LINProtectedIdentifier( 0x3C ) == 0x3C, "LIN PID parity" );
+static_assert( LINProtectedIdentifier( 0x3D ) == 0x7D, "LIN PID parity" );
+
+// every byte value the PID field can hold, and whether it is a valid PID. The decoder checks each PID against this.
+#define LIN_VALID_PIDS_4( pid ) LINIsValidPID( pid ), LINIsValidPID( pid + 1 ), LINIsValidPID( pid + 2 ), LINIsValidPID( pid + 3 )
+#define LIN_VALID_PIDS_16( pid ) \
+    LIN_VALID_PIDS_4( pid ), LIN_VALID_PIDS_4( pid + 4 ), LIN_VALID_PIDS_4( pid + 8 ), LIN_VALID_PIDS_4( pid + 12 )
+#define LIN_VALID_PIDS_64( pid ) \
+    LIN_VALID_PIDS_16( pid ), LIN_VALID_PIDS_16( pid + 16 ), LIN_VALID_PIDS_16( pid + 32 ), LIN_VALID_PIDS_16( pid + 48 )
+
+constexpr bool LINValidPIDs[ 256 ] = { LIN_VALID_PIDS_64( 0 ), LIN_VALID_PIDS_64( 64 ), LIN_VALID_PIDS_64( 128 ),
+                                       LIN_VALID_PIDS_64( 192 ) };
+
+#undef LIN_VALID_PIDS_64
+#undef LIN_VALID_PIDS_16
+#undef LIN_VALID_PIDS_4
+
+static_assert( LINValidPIDs[ 0x80 ] && !LINValidPIDs[ 0x00 ] && LINValidPIDs[ 0x7D ] && !LINValidPIDs[ 0xFD ], "LIN PID table" );
+
+#endif // LIN_PROTECTED_IDENTIFIER_H
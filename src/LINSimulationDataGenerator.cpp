@@ -1,13 +1,69 @@
 #include "LINSimulationDataGenerator.h"
 #include "LINAnalyzerSettings.h"
+#include "LINDecoder.h"
+#include "LINDescriptionFile.h"
+#include "LINProtectedIdentifier.h"
 
 #include <AnalyzerHelpers.h>
 
-#if defined( __GNUC__ )
-#include <stdlib.h>
-#endif
+namespace
+{
+    // a serial byte on the wire: two bits of inter-byte space, the start bit, eight data bits LSB first and two stop bits.
+    // Worked out once per byte value as the lengths, in bits, of its runs of one level. The runs alternate, starting high.
+    // A byte with a framing error has its first stop bit low.
+    struct SerialByteRuns
+    {
+        U32 mCount;
+        U8 mBits[ 11 ];
+    };
+
+    class SerialByteTable
+    {
+      public:
+        SerialByteTable()
+        {
+            for( U32 value = 0; value < 512; value++ )
+            {
+                bool levels[ 13 ] = { true, true, false };
+                for( U32 i = 0; i < 8; i++ )
+                    levels[ 3 + i ] = ( ( value >> i ) & 1 ) != 0;
+                levels[ 11 ] = value < 256;
+                levels[ 12 ] = true;
+
+                SerialByteRuns& runs = mRuns[ value ];
+                runs.mCount = 1;
+                runs.mBits[ 0 ] = 1;
+                for( U32 i = 1; i < 13; i++ )
+                {
+                    if( levels[ i ] == levels[ i - 1 ] )
+                        ++runs.mBits[ runs.mCount - 1 ];
+                    else
+                        runs.mBits[ runs.mCount++ ] = 1;
+                }
+            }
+        }
+
+        const SerialByteRuns& Get( U8 value, bool stop_bit ) const
+        {
+            return mRuns[ stop_bit ? value : value + 256 ];
+        }
+
+      private:
+        SerialByteRuns mRuns[ 512 ];
+    };
+
+    const SerialByteTable& GetSerialByteTable()
+    {
+        static const SerialByteTable table;
+        return table;
+    }
+
+    // the break: two bits of inter-byte space, 13 dominant bits and a two bit delimiter.
+    const U8 BreakFieldRuns[] = { 2, 13, 2 };
+}
 
 LINSimulationDataGenerator::LINSimulationDataGenerator()
+    : mBitTimeRemainder( 0 ), mRandomState( 1 ), mScheduleIndex( 0 ), mReplay( false ), mImpaired( false ), mClockScale( 1000 )
 {
 }
 
@@ -19,6 +75,29 @@ void LINSimulationDataGenerator::Initialize( U32 simulation_sample_rate, LINAnal
 {
     mSimulationSampleRateHz = simulation_sample_rate;
     mSettings = settings;
+    mBitTimeRemainder = 0;
+    Seed( mSettings->mSimulationSeed );
+
+    LINDescriptionFile description;
+    description.Load( mSettings->mDescriptionFile.c_str() );
+    mProfile.Build( *mSettings, description );
+    mScheduleIndex = 0;
+
+    // the trace is opened here, but only read as far as the simulation has got.
+    mReplay = false;
+    if( mSettings->mSimulationTraffic == LINAnalyzerSettings::SimulateReplay )
+        mReplay = mTrace.Open( mSettings->mSimulationTraceFile.c_str() );
+
+    LINImpairments impairments;
+    impairments.Build( *mSettings );
+    SetImpairments( impairments );
+
+    for( U32 bits = 0; bits < BitSampleTableSize; bits++ )
+    {
+        U64 bit_time = U64( bits ) * mSimulationSampleRateHz;
+        mBitSamples[ bits ] = bit_time / mSettings->mBitRate;
+        mBitRemainders[ bits ] = U32( bit_time % mSettings->mBitRate );
+    }
 
     mSerialSimulationData.SetChannel( mSettings->mInputChannel );
     mSerialSimulationData.SetSampleRate( simulation_sample_rate );
@@ -33,65 +112,115 @@ U32 LINSimulationDataGenerator::GenerateSimulationData( U64 largest_sample_reque
 
     while( mSerialSimulationData.GetCurrentSampleNumber() < adjusted_largest_sample_requested )
     {
-        CreateFrame();
-        // CreateFrame();
-        // CreateBadFrame();
+        if( mReplay )
+            ReplayFrame( adjusted_largest_sample_requested );
+        else
+            CreateFrame();
     }
 
     *simulation_channel = &mSerialSimulationData;
     return 1;
 }
 
-void LINSimulationDataGenerator::CreateFrame()
+void LINSimulationDataGenerator::SetTrafficProfile( const LINTrafficProfile& profile )
 {
-    U32 samples_per_bit = mSimulationSampleRateHz / mSettings->mBitRate;
-    mSerialSimulationData.Advance( samples_per_bit * Random( 1, 4 ) ); // simulate jitter
-    CreateHeader();
-    if( mSettings->mLINVersion < 2 )
-        mChecksum.clear(); // Version 1 starts chksum at first data byte
-    CreateReponse( Random( 1, 8 ) );
+    mProfile = profile;
+    mScheduleIndex = 0;
 }
 
-void LINSimulationDataGenerator::CreateBadFrame()
+void LINSimulationDataGenerator::SetImpairments( const LINImpairments& impairments )
 {
-    U32 samples_per_bit = mSimulationSampleRateHz / mSettings->mBitRate;
-    mSerialSimulationData.Advance( samples_per_bit * Random( 1, 4 ) ); // simulate jitter
-    U8 identifier = CreateHeader();
-    bool classic_identifier = false;
-    if( identifier == 0x3C || identifier == 0x3D )
-        classic_identifier = true;
+    mImpairments = impairments;
+    mImpaired = !impairments.IsEmpty();
+    mClockScale = 1000;
+}
 
-    if( mSettings->mLINVersion < 2 || classic_identifier == true )
-        mChecksum.clear(); // Version 1 starts chksum at first data byte.
-    U32 data_count = Random( 1, 8 );
+void LINSimulationDataGenerator::CreateFrame()
+{
+    LINTrafficProfile::Slot slot = NextSlot();
+    tLINSimulationError error = NextError();
 
-    data_count = 5;
-    for( U8 i = 0; i < data_count && i < 8; i++ )
+    AdvanceBits( Random( 1, 4 ) ); // simulate jitter
+    if( error != NoError )
     {
-        CreateSerialByte( static_cast<U8>( Random( 0, 255 ) & 0xFF ) );
+        CreateBadFrame( slot, error );
+    }
+    else
+    {
+        CreateHeader( slot, false );
+        CreateReponse( slot.mLength );
+    }
+
+    // idle long enough that the frame takes up mBusLoad percent of the bus time. The break is 17 bits with the space
+    // before it, and each byte 13.
+    if( mProfile.mBusLoad > 0 && mProfile.mBusLoad < 100 )
+    {
+        U32 frame_bits = 17 + 13 * ( 3 + slot.mLength );
+        AdvanceBits( frame_bits * ( 100 - mProfile.mBusLoad ) / mProfile.mBusLoad );
     }
-    CreateSerialByte( mChecksum.result() + 3 );
 }
 
-U8 LINSimulationDataGenerator::CreateHeader()
+// the next frame of the trace, from its recorded bytes, with its break where it was recorded. Once the trace has run out, the
+// bus idles until `idle_until`.
+void LINSimulationDataGenerator::ReplayFrame( U64 idle_until )
 {
+    const U64 now = mSerialSimulationData.GetCurrentSampleNumber();
+    LINFrameTableReader::Record record;
+    if( !mTrace.Next( record ) )
+    {
+        AdvanceSamples( idle_until - now );
+        return;
+    }
+
+    // in simulation samples; the trace may have been recorded at another sample rate. A frame that would start before the
+    // last one ended, at a different bit rate, goes straight after it instead.
+    const U64 trace_rate = mTrace.GetSampleRate();
+    const U64 start = record.mTimestamp / trace_rate * mSimulationSampleRateHz +
+                      record.mTimestamp % trace_rate * mSimulationSampleRateHz / trace_rate;
+    const U64 space = mBitSamples[ BreakFieldRuns[ 0 ] ];
+    if( start > now + space )
+        AdvanceSamples( start - space - now );
+
+    mClockScale = 1000;
     CreateBreakField();
     CreateSyncField();
-    mChecksum.clear(); // version 2 starts chksum at PID field.
-    U8 identifier = Random( 0, 59 );
+    if( record.mIdentifier == LINFrameTableNoID )
+        return;
+
+    CreateProtectedIdentifierField( record.mIdentifier, ( record.mFlags & LINDecoder::pidParityError ) != 0 );
+    CreateResponseSpace();
+    for( U32 i = 0; i < record.mLength; i++ )
+        CreateSerialByte( record.mData[ i ] );
+    if( ( record.mFlags & LINFrameTableNoChecksum ) == 0 )
+        CreateSerialByte( record.mChecksum ); // as recorded, right or wrong.
+}
 
-    if( Random( 1, 6 ) == 6 )
-        identifier = 0x3C;
-    if( Random( 1, 6 ) == 5 )
-        identifier = 0x3D;
+void LINSimulationDataGenerator::CreateBadFrame( const LINTrafficProfile::Slot& slot, tLINSimulationError error )
+{
+    CreateHeader( slot, error == ParityError );
+    CreateResponseSpace();
 
-    CreateProtectedIdentifierField( identifier );
+    U32 bad_byte = error == FramingError ? Random( 0, slot.mLength - 1 ) : 8;
+    for( U32 i = 0; i < slot.mLength && i < 8; i++ )
+        CreateSerialByte( static_cast<U8>( Random( 0, 255 ) ), i != bad_byte );
 
-    return identifier;
+    CreateSerialByte( error == ChecksumError ? mChecksum.result() + 3 : mChecksum.result() );
+}
+
+void LINSimulationDataGenerator::CreateHeader( const LINTrafficProfile::Slot& slot, bool parity_error )
+{
+    mClockScale = 1000; // the master sends the header.
+    CreateBreakField();
+    CreateSyncField();
+    mChecksum.clear(); // version 2 starts chksum at PID field.
+    CreateProtectedIdentifierField( slot.mIdentifier, parity_error );
+    if( !slot.mEnhancedChecksum )
+        mChecksum.clear(); // the classic checksum starts at the first data byte
 }
 
 void LINSimulationDataGenerator::CreateReponse( U8 length )
 {
+    CreateResponseSpace();
     for( U8 i = 0; i < length && i < 8; i++ )
     {
         U8 data_byte = Random( 0, 255 ) & 0xFF;
@@ -104,46 +233,30 @@ void LINSimulationDataGenerator::CreateReponse( U8 length )
     CreateSerialByte( mChecksum.result() );
 }
 
-void LINSimulationDataGenerator::CreateBreakField()
+// the slave answers after a delay, on a clock of its own.
+void LINSimulationDataGenerator::CreateResponseSpace()
 {
-    // The break field.
-    U32 samples_per_bit = ( mSimulationSampleRateHz / mSettings->mBitRate ) + 1; // to fix round off error
-    U8 byte1 = 0x0;
-    U8 byte2 = 0xE0;
-
-    mChecksum.add( byte1 );
-    SwapEnds( byte1 );
+    if( !mImpaired )
+        return;
 
-    mChecksum.add( byte2 );
-    SwapEnds( byte2 );
-
-    // inter-byte space.....
-    mSerialSimulationData.TransitionIfNeeded( BIT_HIGH );
-    mSerialSimulationData.Advance( samples_per_bit * 2 );
+    mClockScale = 1000 + Random( 0, 2 * mImpairments.mClockDrift ) - mImpairments.mClockDrift;
+    if( mImpairments.mResponseSpace != 0 )
+        mSerialSimulationData.Advance( GetImpairedSamples( Random( 0, mImpairments.mResponseSpace ) ) );
+}
 
+void LINSimulationDataGenerator::CreateBreakField()
+{
     // there is no start bit on the break field.
-    //// start bit...
-    // mSerialSimulationData.Transition( ); 				//low-going edge for start bit
-    // mSerialSimulationData.Advance( samples_per_bit );	//add start bit time
-
-    U16 mask_byte = byte1;
-    mask_byte |= ( ( U16 )byte2 << 8 );
-    U16 mask = 0x1 << 7;
-    U32 accumulator = 0;
-    for( U32 i = 0; i < 13; i++ )
-    {
-        if( ( mask_byte & mask ) != 0 )
-            mSerialSimulationData.TransitionIfNeeded( BIT_HIGH );
-        else
-            mSerialSimulationData.TransitionIfNeeded( BIT_LOW );
-
-        mSerialSimulationData.Advance( samples_per_bit );
-        mask = mask >> 1;
+    if( !mImpaired || ( mImpairments.mShortBreak == 0 && mImpairments.mLongBreak == 0 ) )
+    {
+        CreateRuns( BreakFieldRuns, sizeof( BreakFieldRuns ) );
+        return;
     }
 
-    // stop bit...
-    mSerialSimulationData.TransitionIfNeeded( BIT_HIGH );
-    mSerialSimulationData.Advance( samples_per_bit * 2 );
+    U32 shortest = mImpairments.mShortBreak < 12 ? 13 - mImpairments.mShortBreak : 1;
+    U32 longest = mImpairments.mLongBreak < 200 ? 13 + mImpairments.mLongBreak : 213;
+    U8 runs[] = { BreakFieldRuns[ 0 ], U8( Random( shortest, longest ) ), BreakFieldRuns[ 2 ] };
+    CreateRuns( runs, sizeof( runs ) );
 }
 
 void LINSimulationDataGenerator::CreateSyncField()
@@ -151,62 +264,165 @@ void LINSimulationDataGenerator::CreateSyncField()
     CreateSerialByte( 0x55 ); // The sync byte field.
 }
 
-void LINSimulationDataGenerator::CreateProtectedIdentifierField( U8 id )
+void LINSimulationDataGenerator::CreateProtectedIdentifierField( U8 id, bool parity_error )
 {
-    U8 p0 = ( id & 1 ) ^ ( ( id >> 1 ) & 1 ) ^ ( ( id >> 2 ) & 1 ) ^ ( ( id >> 4 ) & 1 );          // P0 Parity
-    U8 p1 = ( ( id >> 1 ) & 1 ) ^ ( ( id >> 3 ) & 1 ) ^ ( ( id >> 4 ) & 1 ) ^ ( ( id >> 5 ) & 1 ); // P1 Parity
-    CreateSerialByte( ( id & 0x3F ) | ( ( p0 & 1 ) << 6 ) | ( ( p1 & 1 ) << 7 ) );
+    U8 pid = LINProtectedIdentifier( id );
+    CreateSerialByte( parity_error ? U8( pid ^ 0x80 ) : pid );
 }
 
-void LINSimulationDataGenerator::CreateSerialByte( U8 byte )
+void LINSimulationDataGenerator::CreateSerialByte( U8 byte, bool stop_bit )
 {
-    U32 samples_per_bit = mSimulationSampleRateHz / mSettings->mBitRate;
-
     mChecksum.add( byte );
-    SwapEnds( byte );
 
-    // inter-byte space.....
-    mSerialSimulationData.TransitionIfNeeded( BIT_HIGH );
-    mSerialSimulationData.Advance( samples_per_bit * 2 );
+    const SerialByteRuns& runs = GetSerialByteTable().Get( byte, stop_bit );
+    CreateRuns( runs.mBits, runs.mCount );
+}
 
-    // start bit...
-    mSerialSimulationData.Transition();               // low-going edge for start bit
-    mSerialSimulationData.Advance( samples_per_bit ); // add start bit time
+// one edge per run rather than a call per bit. The first run is high, from the idle bus or the last stop bit.
+void LINSimulationDataGenerator::CreateRuns( const U8* bits, U32 count )
+{
+    if( mImpaired )
+    {
+        CreateImpairedRuns( bits, count );
+        return;
+    }
 
-    U8 mask = 0x1 << 7;
-    for( U32 i = 0; i < 8; i++ )
+    mSerialSimulationData.TransitionIfNeeded( BIT_HIGH );
+    AdvanceBits( bits[ 0 ] );
+    for( U32 i = 1; i < count; i++ )
     {
-        if( ( byte & mask ) != 0 )
-            mSerialSimulationData.TransitionIfNeeded( BIT_HIGH );
-        else
-            mSerialSimulationData.TransitionIfNeeded( BIT_LOW );
+        mSerialSimulationData.Transition();
+        AdvanceBits( bits[ i ] );
+    }
+}
+// the impairment stage, between the byte encoder and the channel: the runs are stretched by the sender's clock, the space
+// before the byte is lengthened, and now and then a glitch is dropped into a run.
+void LINSimulationDataGenerator::CreateImpairedRuns( const U8* bits, U32 count )
+{
+    mSerialSimulationData.TransitionIfNeeded( BIT_HIGH );
+    for( U32 i = 0; i < count; i++ )
+    {
+        if( i != 0 )
+            mSerialSimulationData.Transition();
+
+        U32 millibits = bits[ i ] * 1000;
+        if( i == 0 && mImpairments.mInterByteSpace != 0 )
+            millibits += Random( 0, mImpairments.mInterByteSpace );
+        U32 samples = GetImpairedSamples( millibits );
+
+        U32 glitch = 0;
+        if( mImpairments.mGlitchRate != 0 && Random( 0, 999 ) < mImpairments.mGlitchRate )
+            glitch = 1 + U32( U64( mBitSamples[ 1 ] ) * Random( 0, mImpairments.mGlitchWidth ) / 1000 );
+        if( glitch != 0 && samples > glitch + 1 )
+        {
+            U32 before = Random( 1, samples - glitch - 1 );
+            mSerialSimulationData.Advance( before );
+            mSerialSimulationData.Transition();
+            mSerialSimulationData.Advance( glitch );
+            mSerialSimulationData.Transition();
+            samples -= before + glitch;
+        }
+        mSerialSimulationData.Advance( samples );
+    }
+}
 
-        mSerialSimulationData.Advance( samples_per_bit );
-        mask = mask >> 1;
+void LINSimulationDataGenerator::AdvanceBits( U32 bits )
+{
+    // carry the fraction of a sample left over from each run, so the simulated bit rate is exact rather than rounded down.
+    // Runs are at most 13 bits, so their whole and fractional samples are looked up rather than divided out.
+    U64 samples;
+    if( bits < BitSampleTableSize )
+    {
+        samples = mBitSamples[ bits ];
+        mBitTimeRemainder += mBitRemainders[ bits ];
+        if( mBitTimeRemainder >= mSettings->mBitRate )
+        {
+            mBitTimeRemainder -= mSettings->mBitRate;
+            ++samples;
+        }
+    }
+    else
+    {
+        mBitTimeRemainder += U64( bits ) * mSimulationSampleRateHz;
+        samples = mBitTimeRemainder / mSettings->mBitRate;
+        mBitTimeRemainder -= samples * mSettings->mBitRate;
     }
+    mSerialSimulationData.Advance( U32( samples ) );
+}
 
-    // stop bit...
-    mSerialSimulationData.TransitionIfNeeded( BIT_HIGH );
-    mSerialSimulationData.Advance( samples_per_bit * 2 );
+void LINSimulationDataGenerator::AdvanceSamples( U64 samples )
+{
+    // Advance() takes at most 32 bits; idle time between replayed frames can be longer.
+    while( samples > 0x80000000ull )
+    {
+        mSerialSimulationData.Advance( 0x80000000u );
+        samples -= 0x80000000ull;
+    }
+    mSerialSimulationData.Advance( U32( samples ) );
 }
 
-void LINSimulationDataGenerator::SwapEnds( U8& byte )
+// samples in `millibits` thousandths of a bit at mClockScale, carrying the fraction left over as AdvanceBits() does.
+U32 LINSimulationDataGenerator::GetImpairedSamples( U32 millibits )
 {
-    U8 t = 0;
-    for( int n = 7; n >= 0; n-- )
+    mBitTimeRemainder += U64( millibits ) * mClockScale * mSimulationSampleRateHz / 1000000;
+    U64 samples = mBitTimeRemainder / mSettings->mBitRate;
+    mBitTimeRemainder -= samples * mSettings->mBitRate;
+    return U32( samples );
+}
+
+LINTrafficProfile::Slot LINSimulationDataGenerator::NextSlot()
+{
+    if( !mProfile.mSchedule.empty() )
     {
-        t |= ( ( byte >> n ) & 1 ) << 7;
-        if( n )
-            t >>= 1;
+        if( mScheduleIndex >= mProfile.mSchedule.size() )
+            mScheduleIndex = 0;
+        return mProfile.mSchedule[ mScheduleIndex++ ];
     }
-    byte = t;
+
+    LINTrafficProfile::Slot slot;
+    slot.mIdentifier = Random( 0, 59 );
+    if( Random( 1, 6 ) == 6 )
+        slot.mIdentifier = 0x3C;
+    if( Random( 1, 6 ) == 5 )
+        slot.mIdentifier = 0x3D;
+    slot.mLength = Random( 1, 8 );
+    slot.mEnhancedChecksum = LINChecksum::IsEnhanced( mSettings->mLINVersion, slot.mIdentifier );
+    return slot;
 }
 
-U32 LINSimulationDataGenerator::Random( U32 min, U32 max )
+LINSimulationDataGenerator::tLINSimulationError LINSimulationDataGenerator::NextError()
 {
-    return min + ( rand() % ( max - min + 1 ) );
+    if( mProfile.GetErrorRate() == 0 )
+        return NoError;
+
+    U32 draw = Random( 0, 999 );
+    if( draw < mProfile.mChecksumErrors )
+        return ChecksumError;
+    draw -= mProfile.mChecksumErrors;
+    if( draw < mProfile.mParityErrors )
+        return ParityError;
+    draw -= mProfile.mParityErrors;
+    if( draw < mProfile.mFramingErrors )
+        return FramingError;
+    return NoError;
+}
 
+void LINSimulationDataGenerator::Seed( U32 seed )
+{
+    // splitmix64 spreads small, similar seeds over the whole state.
+    U64 state = seed + 0x9E3779B97F4A7C15ull;
+    state = ( state ^ ( state >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+    state = ( state ^ ( state >> 27 ) ) * 0x94D049BB133111EBull;
+    state ^= state >> 31;
+    mRandomState = state != 0 ? state : 1;
+}
 
-    U32 rc = min + ( int )( ( double )max * ( rand() / ( RAND_MAX + 1.0 ) ) );
-    return rc;
+// min to max inclusive. The generator is per instance, so one analyzer's simulation doesn't disturb another's.
+U32 LINSimulationDataGenerator::Random( U32 min, U32 max )
+{
+    mRandomState ^= mRandomState >> 12;
+    mRandomState ^= mRandomState << 25;
+    mRandomState ^= mRandomState >> 27;
+    U64 random = ( mRandomState * 0x2545F4914F6CDD1Dull ) >> 32;
+    return min + U32( ( random * ( U64( max - min ) + 1 ) ) >> 32 );
 }
@@ -5,6 +5,9 @@
 #include <string>
 
 #include "LINChecksum.h"
+#include "LINFrameTableReader.h"
+#include "LINImpairments.h"
+#include "LINTrafficProfile.h"
 
 class LINAnalyzerSettings;
 
@@ -17,21 +20,58 @@ class LINSimulationDataGenerator
     void Initialize( U32 simulation_sample_rate, LINAnalyzerSettings* settings );
     U32 GenerateSimulationData( U64 newest_sample_requested, U32 sample_rate, SimulationChannelDescriptor** simulation_channel );
 
+    // Initialize() builds the profile from the settings; this replaces it, for load and regression tests.
+    void SetTrafficProfile( const LINTrafficProfile& profile );
+    void SetImpairments( const LINImpairments& impairments );
+
   protected:
+    typedef enum
+    {
+        NoError = 0,
+        ChecksumError,
+        ParityError,
+        FramingError,
+    } tLINSimulationError;
+
     void CreateFrame();
-    void CreateBadFrame();
-    U8 CreateHeader();
+    void ReplayFrame( U64 idle_until );
+    void CreateBadFrame( const LINTrafficProfile::Slot& slot, tLINSimulationError error );
+    void CreateHeader( const LINTrafficProfile::Slot& slot, bool parity_error );
     void CreateReponse( U8 length );
+    void CreateResponseSpace();
     void CreateBreakField();
     void CreateSyncField();
-    void CreateProtectedIdentifierField( U8 id );
-    void CreateSerialByte( U8 byte );
-    void SwapEnds( U8& byte );
+    void CreateProtectedIdentifierField( U8 id, bool parity_error );
+    void CreateSerialByte( U8 byte, bool stop_bit = true );
+    void CreateRuns( const U8* bits, U32 count );
+    void CreateImpairedRuns( const U8* bits, U32 count );
+    void AdvanceBits( U32 bits );
+    void AdvanceSamples( U64 samples );
+    U32 GetImpairedSamples( U32 millibits );
+    LINTrafficProfile::Slot NextSlot();
+    tLINSimulationError NextError();
+    void Seed( U32 seed );
     U32 Random( U32 min, U32 max );
 
   private:
     LINAnalyzerSettings* mSettings;
     U32 mSimulationSampleRateHz;
+    U64 mBitTimeRemainder; // sample rate * bits not yet advanced, in units of 1 / bit rate.
+    U64 mRandomState;      // xorshift64*, never 0.
+    LINTrafficProfile mProfile;
+    U32 mScheduleIndex;
+    LINFrameTableReader mTrace;
+    bool mReplay; // whether frames come from mTrace.
+    LINImpairments mImpairments;
+    bool mImpaired;     // whether runs go through CreateImpairedRuns().
+    U32 mClockScale;    // per mille of the nominal bit time, for the bytes being sent.
+
+    enum
+    {
+        BitSampleTableSize = 16
+    };
+    U64 mBitSamples[ BitSampleTableSize ];    // whole samples in 0-15 bits.
+    U32 mBitRemainders[ BitSampleTableSize ]; // and the fraction left over, in units of 1 / bit rate.
     SimulationChannelDescriptor mSerialSimulationData;
     LINChecksum mChecksum;
 };
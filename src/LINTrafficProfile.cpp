@@ -0,0 +1,62 @@
+#include "LINTrafficProfile.h"
+#include "LINAnalyzerSettings.h"
+#include "LINChecksum.h"
+#include "LINDescriptionFile.h"
+
+LINTrafficProfile::LINTrafficProfile()
+{
+    Clear();
+}
+
+void LINTrafficProfile::Clear()
+{
+    mSchedule.clear();
+    mBusLoad = 100;
+    mChecksumErrors = 0;
+    mParityErrors = 0;
+    mFramingErrors = 0;
+}
+
+void LINTrafficProfile::Build( const LINAnalyzerSettings& settings, const LINDescriptionFile& description )
+{
+    Clear();
+    mBusLoad = settings.mSimulationBusLoad;
+    if( mBusLoad < 1 || mBusLoad > 100 )
+        mBusLoad = 100;
+
+    // the one rate setting is shared evenly between the kinds of error.
+    U32 errors = settings.mSimulationErrorRate < 1000 ? settings.mSimulationErrorRate : 1000;
+    mChecksumErrors = errors / 3;
+    mParityErrors = errors / 3;
+    mFramingErrors = errors - mChecksumErrors - mParityErrors;
+
+    if( settings.mSimulationTraffic != LINAnalyzerSettings::SimulateSchedule )
+        return;
+
+    for( U32 identifier = 0; identifier < 64; identifier++ )
+    {
+        Slot slot;
+        slot.mIdentifier = U8( identifier );
+        const LINDescriptionFile::FrameInfo* frame = description.GetFrame( U8( identifier ) );
+        if( frame != NULL )
+        {
+            slot.mLength = frame->mLength;
+            slot.mEnhancedChecksum = frame->mEnhancedChecksum;
+        }
+        else if( description.IsEmpty() && identifier < 60 )
+        {
+            slot.mLength = identifier < 32 ? 2 : ( identifier < 48 ? 4 : 8 );
+            slot.mEnhancedChecksum = LINChecksum::IsEnhanced( settings.mLINVersion, U8( identifier ) );
+        }
+        else
+        {
+            continue;
+        }
+        mSchedule.push_back( slot );
+    }
+}
+
+U32 LINTrafficProfile::GetErrorRate() const
+{
+    return mChecksumErrors + mParityErrors + mFramingErrors;
+}
@@ -0,0 +1,40 @@
+#ifndef LIN_TRAFFIC_PROFILE_H
+#define LIN_TRAFFIC_PROFILE_H
+
+#include <LogicPublicTypes.h>
+#include <vector>
+
+class LINAnalyzerSettings;
+class LINDescriptionFile;
+
+// what the simulation data generator puts on the bus: which frames and in what order, how busy the bus is, and how often a
+// frame goes out with an error in it.
+class LINTrafficProfile
+{
+  public:
+    struct Slot
+    {
+        U8 mIdentifier;
+        U8 mLength; // data bytes, 1-8.
+        bool mEnhancedChecksum;
+    };
+
+    LINTrafficProfile();
+
+    // random identifiers and lengths on a busy bus, with no errors; the traffic the simulator has always made.
+    void Clear();
+
+    // from the simulation settings. A schedule table takes its frames from `description`, in identifier order, or every
+    // unconditional frame with LIN 1.x lengths if there's no description.
+    void Build( const LINAnalyzerSettings& settings, const LINDescriptionFile& description );
+
+    U32 GetErrorRate() const; // all errors, per 1000 frames.
+
+    std::vector<Slot> mSchedule; // sent in order, over and over. Empty for random traffic.
+    U32 mBusLoad;                // percent of the bus time spent sending frames, 1-100. Approximate: there's jitter on top.
+    U32 mChecksumErrors;         // per 1000 frames: a wrong checksum.
+    U32 mParityErrors;           // per 1000 frames: a PID with a bad parity bit.
+    U32 mFramingErrors;          // per 1000 frames: a data byte without its stop bit.
+};
+
+#endif // LIN_TRAFFIC_PROFILE_H
@@ -0,0 +1,12 @@
+#ifndef LIN_TYPES_H
+#define LIN_TYPES_H
+
+// the AnalyzerSDK's integer names, for the code that builds without the SDK. The typedefs are the same as those in
+// LogicPublicTypes.h, so the two headers can be included together.
+typedef unsigned char U8;
+typedef unsigned short U16;
+typedef unsigned int U32;
+typedef unsigned long long int U64;
+typedef long long int S64;
+
+#endif // LIN_TYPES_H
@@ -0,0 +1,65 @@
+#include "LINTest.h"
+#include "LINTestHarness.h"
+#include <new>
+#include <stdlib.h>
+
+// counts every heap allocation in the test program.
+namespace
+{
+    U64 gAllocations = 0;
+}
+
+void* operator new( size_t size )
+{
+    ++gAllocations;
+    void* memory = malloc( size != 0 ? size : 1 );
+    if( memory == NULL )
+        throw std::bad_alloc();
+    return memory;
+}
+
+void operator delete( void* memory ) noexcept
+{
+    free( memory );
+}
+
+namespace
+{
+    // heap allocations made while decoding `frame_count` frames. The mock SDK's own storage is reserved up front and its
+    // FrameV2 records nothing, so only the analyzer's allocations are counted.
+    U64 DecodeAllocations( U32 frame_count, LINAnalyzerSettings::tLINFrameOutput frame_output )
+    {
+        const U8 data[] = { 0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF };
+        LINWaveform waveform( 1000000, 19200 );
+        waveform.Idle( 20 );
+        for( U32 i = 0; i < frame_count; i++ )
+            waveform.Frame( U8( i % 60 ), data, 1 + i % 8, true );
+        waveform.Idle( 20 );
+
+        LINTestAnalyzer analyzer( 1000000, 19200 );
+        analyzer.Settings().mFrameOutput = frame_output;
+        analyzer.SetupResults();
+        analyzer.Results().mFrames.reserve( frame_count * 24 );
+        analyzer.Results().mMarkers.reserve( frame_count * 140 );
+        analyzer.Results().mPackets.reserve( frame_count );
+        analyzer.Results().mKeepFramesV2 = false;
+        FrameV2::sKeepEntries = false;
+
+        U64 before = gAllocations;
+        analyzer.Run( waveform );
+        U64 allocations = gAllocations - before;
+
+        FrameV2::sKeepEntries = true;
+        LIN_CHECK_EQUAL( frame_count, analyzer.Results().GetNumPackets() );
+        return allocations;
+    }
+}
+
+// the decoder allocates while it starts up, and never per byte after that.
+LIN_TEST( NoAllocationsPerByte )
+{
+    LIN_CHECK_EQUAL( DecodeAllocations( 10, LINAnalyzerSettings::ByteFrameOutput ),
+                     DecodeAllocations( 1000, LINAnalyzerSettings::ByteFrameOutput ) );
+    LIN_CHECK_EQUAL( DecodeAllocations( 10, LINAnalyzerSettings::LINFrameOutput ),
+                     DecodeAllocations( 1000, LINAnalyzerSettings::LINFrameOutput ) );
+}
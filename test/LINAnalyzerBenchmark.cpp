@@ -0,0 +1,505 @@
+#include "LINTestHarness.h"
+#include "LINChecksum.h"
+#include "LINProtectedIdentifier.h"
+#include <chrono>
+#include <new>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// decoder throughput across sample rates, bit rates, payload lengths, error densities and commit policies, or with --simulation, how fast
+// the simulation data generator runs, or with --checksum, how fast frames are checksummed one at a time and in a batch,
+// or with --text, how fast the bubble, tabular and export text is formatted, or with --export, how fast each export
+// format is written. Prints one CSV row per run, so the output can be kept and compared between builds. Configure with
+// -DLIN_ANALYZER_TESTS=ON, then run
+// lin_analyzer_benchmark [--simulation | --checksum | --text | --export] [--quick] [--frames N] [--repeat N].
+
+// every heap allocation is counted, and its size kept in front of the block so the live heap can be tracked.
+namespace
+{
+    const size_t HeapHeader = 16; // keeps the block aligned for any type.
+    U64 gAllocations = 0;
+    U64 gHeapBytes = 0;
+    U64 gPeakHeapBytes = 0;
+}
+
+void* operator new( size_t size )
+{
+    char* memory = static_cast<char*>( malloc( size + HeapHeader ) );
+    if( memory == NULL )
+        throw std::bad_alloc();
+    *reinterpret_cast<size_t*>( memory ) = size;
+    ++gAllocations;
+    gHeapBytes += size;
+    if( gHeapBytes > gPeakHeapBytes )
+        gPeakHeapBytes = gHeapBytes;
+    return memory + HeapHeader;
+}
+
+void operator delete( void* memory ) noexcept
+{
+    if( memory == NULL )
+        return;
+    char* block = static_cast<char*>( memory ) - HeapHeader;
+    gHeapBytes -= *reinterpret_cast<size_t*>( block );
+    free( block );
+}
+
+namespace
+{
+    struct BenchmarkConfig
+    {
+        U32 mSampleRate;
+        U32 mBitRate;
+        U32 mPayloadLength;
+        double mErrorDensity; // fraction of frames sent with an error in them.
+        LINAnalyzerSettings::tLINCommitPolicy mCommitPolicy;
+    };
+
+    struct BenchmarkResult
+    {
+        U64 mBusBytes;      // sync, PID, data and checksum bytes sent.
+        U64 mSamples;       // length of the capture.
+        U64 mPackets;       // LIN frames the decoder found.
+        U64 mErrorFrames;   // byte frames the decoder flagged.
+        U64 mCommits;       // CommitResults() calls.
+        double mSeconds;    // fastest decode of the repeats.
+        U64 mAllocations;   // during one decode.
+        U64 mPeakHeapBytes; // heap growth during one decode.
+    };
+
+    // `frame_count` frames of `payload_length` bytes. A frame picked for an error gets one of: a bad checksum, a PID
+    // parity error, or a data byte with no stop bit. The generator is seeded so every build sees the same traffic.
+    U64 BuildWaveform( LINWaveform& waveform, const BenchmarkConfig& config, U32 frame_count )
+    {
+        std::mt19937 random( 1 );
+        std::uniform_real_distribution<double> chance( 0, 1 );
+        U8 data[ 8 ];
+
+        waveform.Idle( 20 );
+        for( U32 i = 0; i < frame_count; i++ )
+        {
+            const U8 identifier = U8( i % 60 );
+            for( U32 b = 0; b < config.mPayloadLength; b++ )
+                data[ b ] = U8( random() );
+
+            const bool error = chance( random ) < config.mErrorDensity;
+            const U32 kind = error ? random() % 3 : 0;
+            if( !error || kind == 0 )
+            {
+                waveform.Frame( identifier, data, config.mPayloadLength, true, error );
+            }
+            else
+            {
+                const U8 pid = LINProtectedIdentifier( identifier );
+                waveform.Break();
+                waveform.Byte( 0x55 );
+                waveform.Byte( kind == 1 ? U8( pid ^ 0x80 ) : pid );
+                for( U32 b = 0; b < config.mPayloadLength; b++ )
+                    waveform.Byte( data[ b ], kind != 2 || b != 0 );
+                waveform.Byte( LINEnhancedChecksumEngine::Compute( pid, data, config.mPayloadLength ) );
+            }
+            waveform.Idle( 4 );
+        }
+        waveform.Idle( 20 );
+        return U64( frame_count ) * ( config.mPayloadLength + 3 );
+    }
+
+    BenchmarkResult Measure( const BenchmarkConfig& config, U32 frame_count, U32 repeat )
+    {
+        LINWaveform waveform( config.mSampleRate, config.mBitRate );
+        BenchmarkResult result;
+        result.mBusBytes = BuildWaveform( waveform, config, frame_count );
+        result.mSamples = waveform.GetSample();
+        result.mSeconds = 0;
+
+        for( U32 r = 0; r < repeat; r++ )
+        {
+            // the mock SDK's storage is reserved up front and its FrameV2 records nothing, so only the analyzer's own
+            // allocations are counted.
+            LINTestAnalyzer analyzer( config.mSampleRate, config.mBitRate );
+            analyzer.Settings().mCommitPolicy = config.mCommitPolicy;
+            analyzer.Load( waveform );
+            analyzer.Results().mFrames.reserve( frame_count * 24 );
+            analyzer.Results().mMarkers.reserve( frame_count * 140 );
+            analyzer.Results().mPackets.reserve( frame_count * 2 ); // errors can split a frame in two.
+            analyzer.Results().mKeepFramesV2 = false;
+            FrameV2::sKeepEntries = false;
+
+            const U64 allocations = gAllocations;
+            const U64 heap_bytes = gHeapBytes;
+            gPeakHeapBytes = gHeapBytes;
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            analyzer.RunToCompletion();
+            double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+            FrameV2::sKeepEntries = true;
+
+            if( r == 0 || seconds < result.mSeconds )
+                result.mSeconds = seconds;
+            result.mAllocations = gAllocations - allocations;
+            result.mPeakHeapBytes = gPeakHeapBytes - heap_bytes;
+
+            result.mPackets = analyzer.Results().GetNumPackets();
+            result.mCommits = analyzer.Results().mCommitCount;
+            result.mErrorFrames = 0;
+            for( U64 i = 0; i < analyzer.Results().GetNumFrames(); i++ )
+            {
+                if( analyzer.Results().GetFrame( i ).mFlags != 0 )
+                    ++result.mErrorFrames;
+            }
+        }
+        return result;
+    }
+
+    // the decoder sweep: one row per sample rate, bit rate, payload length, error density and commit policy.
+    void DecoderSweep( bool quick, U32 frame_count, U32 repeat )
+    {
+        // the bit rates span what LINAnalyzerSettings allows. --quick keeps the first and last of each list.
+        const U32 sample_rates[] = { 1000000, 10000000, 100000000, 500000000 };
+        const U32 bit_rates[] = { 1000, 9600, 19200, 100000, 1000000 };
+        const U32 payload_lengths[] = { 1, 4, 8 };
+        const double error_densities[] = { 0, 0.01, 0.1 };
+        const char* const commit_policy_names[] = { "live", "per_packet", "batched" };
+
+        printf( "sample_rate,bit_rate,payload,error_density,commit_policy,frames,bus_bytes,samples,packets,error_frames,commits,"
+                "seconds,ns_per_byte,bytes_per_s,frames_per_s,samples_per_s,realtime_factor,allocations,peak_heap_bytes\n" );
+        for( U32 s = 0; s < 4; s += quick ? 3 : 1 )
+            for( U32 b = 0; b < 5; b += quick ? 4 : 1 )
+                for( U32 p = 0; p < 3; p += quick ? 2 : 1 )
+                    for( U32 e = 0; e < 3; e += quick ? 2 : 1 )
+                        for( U32 c = 0; c < 3; c += quick ? 2 : 1 )
+                        {
+                            BenchmarkConfig config = { sample_rates[ s ], bit_rates[ b ], payload_lengths[ p ], error_densities[ e ],
+                                                       LINAnalyzerSettings::tLINCommitPolicy( c ) };
+                            if( config.mSampleRate < config.mBitRate * 4 ) // below GetMinimumSampleRateHz().
+                                continue;
+
+                            BenchmarkResult result = Measure( config, frame_count, repeat );
+                            const double seconds = result.mSeconds > 0 ? result.mSeconds : 1e-9;
+                            const double samples_per_s = result.mSamples / seconds;
+                            printf( "%u,%u,%u,%g,%s,%u,%llu,%llu,%llu,%llu,%llu,%.6f,%.2f,%.0f,%.0f,%.0f,%.1f,%llu,%llu\n",
+                                    config.mSampleRate, config.mBitRate, config.mPayloadLength, config.mErrorDensity,
+                                    commit_policy_names[ c ], frame_count, ( unsigned long long )result.mBusBytes,
+                                    ( unsigned long long )result.mSamples, ( unsigned long long )result.mPackets,
+                                    ( unsigned long long )result.mErrorFrames, ( unsigned long long )result.mCommits, seconds,
+                                    seconds * 1e9 / result.mBusBytes, result.mBusBytes / seconds, frame_count / seconds, samples_per_s,
+                                    samples_per_s / config.mSampleRate, ( unsigned long long )result.mAllocations,
+                                    ( unsigned long long )result.mPeakHeapBytes );
+                            fflush( stdout );
+                        }
+    }
+
+    // a result set of at least `frame_count` frames for the text and export sweeps. 1000 LIN frames of 8 bytes, 1% of them with an
+    // error, are decoded once, then their frames and packets are repeated further on in the capture as often as needed.
+    void LoadResultSet( LINTestAnalyzer& analyzer, U64 frame_count )
+    {
+        const BenchmarkConfig config = { 1000000, 19200, 8, 0.01, LINAnalyzerSettings::CommitBatched };
+        LINWaveform waveform( config.mSampleRate, config.mBitRate );
+        BuildWaveform( waveform, config, 1000 );
+        analyzer.Run( waveform );
+
+        std::vector<Frame>& frames = analyzer.Results().mFrames;
+        std::vector<std::pair<U64, U64> >& packets = analyzer.Results().mPackets;
+        const size_t seed_frames = frames.size();
+        const size_t seed_packets = packets.size();
+        const size_t copies = size_t( ( frame_count + seed_frames - 1 ) / seed_frames );
+        frames.reserve( copies * seed_frames );
+        packets.reserve( copies * seed_packets );
+        for( size_t copy = 1; copy < copies; copy++ )
+        {
+            const S64 offset = S64( copy * waveform.GetSample() );
+            const U64 first = frames.size();
+            for( size_t i = 0; i < seed_frames; i++ )
+            {
+                Frame frame = frames[ i ];
+                frame.mStartingSampleInclusive += offset;
+                frame.mEndingSampleInclusive += offset;
+                frames.push_back( frame );
+            }
+            for( size_t i = 0; i < seed_packets; i++ )
+            {
+                const std::pair<U64, U64> packet = packets[ i ];
+                packets.push_back( std::make_pair( first + packet.first, first + packet.second ) );
+            }
+        }
+    }
+
+    // the text sweep: GenerateBubbleText(), GenerateFrameTabularText() and the FormatFrame() the text export is built from,
+    // over every frame of a `frame_count` thousand frame result set, in each display base. The mock SDK keeps a std::string
+    // of each result and tabular string, which the bubble and tabular rows include.
+    void TextSweep( U32 frame_count, U32 repeat )
+    {
+        LINTestAnalyzer analyzer( 1000000, 19200 );
+        LoadResultSet( analyzer, U64( frame_count ) * 1000 );
+        LINAnalyzerResults& results = analyzer.Results();
+        Channel channel = analyzer.Settings().mInputChannel;
+        const U64 frames = results.GetNumFrames();
+
+        const char* const methods[] = { "bubble", "tabular", "format" };
+        const char* const display_base_names[] = { "binary", "decimal", "hexadecimal", "ascii", "ascii_hex" };
+        printf( "method,display_base,frames,seconds,ns_per_frame,frames_per_s\n" );
+        for( U32 m = 0; m < 3; m++ )
+            for( U32 d = 0; d < 5; d++ )
+            {
+                const DisplayBase display_base = DisplayBase( d );
+                double best = 0;
+                for( U32 r = 0; r < repeat; r++ )
+                {
+                    char text[ 128 ];
+                    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                    for( U64 i = 0; i < frames; i++ )
+                    {
+                        if( m == 0 )
+                            results.GenerateBubbleText( i, channel, display_base );
+                        else if( m == 1 )
+                            results.GenerateFrameTabularText( i, display_base );
+                        else
+                            results.FormatFrame( results.mFrames[ i ], display_base, LINAnalyzerResults::LongText, text, sizeof( text ) );
+                    }
+                    double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+                    if( r == 0 || seconds < best )
+                        best = seconds;
+                }
+
+                const double seconds = best > 0 ? best : 1e-9;
+                printf( "%s,%s,%llu,%.6f,%.2f,%.0f\n", methods[ m ], display_base_names[ d ], ( unsigned long long )frames, seconds,
+                        seconds * 1e9 / frames, frames / seconds );
+                fflush( stdout );
+            }
+    }
+
+    // the export sweep: GenerateExportFile() in each format, through the mock SDK, over a `frame_count` thousand frame result
+    // set. The file is written to the working directory and removed afterwards.
+    void ExportSweep( U32 frame_count, U32 repeat )
+    {
+        LINTestAnalyzer analyzer( 1000000, 19200 );
+        LoadResultSet( analyzer, U64( frame_count ) * 1000 );
+        LINAnalyzerResults& results = analyzer.Results();
+        const U64 frames = results.GetNumFrames();
+        const U64 packets = results.GetNumPackets();
+
+        const char* path = "lin_analyzer_benchmark.export";
+        const char* const export_names[] = { "text", "binary", "pcap" };
+        const U32 export_types[] = { LINAnalyzerSettings::TextExport, LINAnalyzerSettings::BinaryExport, LINAnalyzerSettings::PcapExport };
+        printf( "export,frames,packets,bytes,seconds,mb_per_s,frames_per_s\n" );
+        for( U32 x = 0; x < 3; x++ )
+        {
+            double best = 0;
+            U64 bytes = 0;
+            for( U32 r = 0; r < repeat; r++ )
+            {
+                std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                results.GenerateExportFile( path, Hexadecimal, export_types[ x ] );
+                double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+                if( r == 0 || seconds < best )
+                    best = seconds;
+
+                FILE* file = fopen( path, "rb" );
+                if( file != NULL )
+                {
+                    fseek( file, 0, SEEK_END );
+                    bytes = U64( ftell( file ) );
+                    fclose( file );
+                }
+                remove( path );
+            }
+
+            const double seconds = best > 0 ? best : 1e-9;
+            printf( "%s,%llu,%llu,%llu,%.6f,%.1f,%.0f\n", export_names[ x ], ( unsigned long long )frames, ( unsigned long long )packets,
+                    ( unsigned long long )bytes, seconds, bytes / seconds / 1e6, frames / seconds );
+            fflush( stdout );
+        }
+    }
+
+    // the checksum sweep: the running per-byte checksum the decoder uses, the engine's Compute() per frame, and the batch
+    // Verify() used on frame tables, over the same frames held as in the binary export. `frame_count` thousand frames of
+    // random length, a tenth of them with a wrong checksum.
+    void ChecksumSweep( U32 frame_count, U32 repeat )
+    {
+        const U32 count = frame_count * 1000;
+        std::vector<U8> pids( count );
+        std::vector<U8> lengths( count );
+        std::vector<U8> data( 8 * size_t( count ), 0 );
+        std::vector<U8> checksums( count );
+        std::vector<U8> mismatches( count );
+        std::mt19937 random( 1 );
+        for( U32 i = 0; i < count; i++ )
+        {
+            pids[ i ] = LINProtectedIdentifier( U8( random() % 60 ) );
+            lengths[ i ] = U8( 1 + random() % 8 );
+            for( U32 b = 0; b < lengths[ i ]; b++ )
+                data[ 8 * size_t( i ) + b ] = U8( random() );
+            checksums[ i ] = LINEnhancedChecksumEngine::Compute( pids[ i ], &data[ 8 * size_t( i ) ], lengths[ i ] );
+            if( random() % 10 == 0 )
+                checksums[ i ] ^= 0x01;
+        }
+
+        const char* const methods[] = { "running", "compute", "verify" };
+        printf( "method,frames,seconds,frames_per_s,ns_per_frame,mismatches\n" );
+        for( U32 m = 0; m < 3; m++ )
+        {
+            double best = 0;
+            U64 mismatch_count = 0;
+            for( U32 r = 0; r < repeat; r++ )
+            {
+                std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                mismatch_count = 0;
+                if( m == 0 )
+                {
+                    LINChecksum checksum;
+                    for( U32 i = 0; i < count; i++ )
+                    {
+                        checksum.clear();
+                        checksum.add( pids[ i ] );
+                        for( U32 b = 0; b < lengths[ i ]; b++ )
+                            checksum.add( data[ 8 * size_t( i ) + b ] );
+                        mismatch_count += checksum.result() != checksums[ i ];
+                    }
+                }
+                else if( m == 1 )
+                {
+                    for( U32 i = 0; i < count; i++ )
+                        mismatch_count +=
+                            LINEnhancedChecksumEngine::Compute( pids[ i ], &data[ 8 * size_t( i ) ], lengths[ i ] ) != checksums[ i ];
+                }
+                else
+                {
+                    mismatch_count = LINEnhancedChecksumEngine::Verify( &pids[ 0 ], &data[ 0 ], &checksums[ 0 ], count, &mismatches[ 0 ] );
+                }
+                double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+                if( r == 0 || seconds < best )
+                    best = seconds;
+            }
+
+            const double seconds = best > 0 ? best : 1e-9;
+            printf( "%s,%u,%.6f,%.0f,%.2f,%llu\n", methods[ m ], count, seconds, count / seconds, seconds * 1e9 / count,
+                    ( unsigned long long )mismatch_count );
+            fflush( stdout );
+        }
+    }
+
+    // the simulation sweep: how much capture GenerateSimulationData() produces per second of wall time, at each sample rate,
+    // bit rate and bus quality, and then how fast and how well the decoder reads it back. `frame_count` sets the length of
+    // the simulated capture, at about 120 bits per frame.
+    void SimulationSweep( bool quick, U32 frame_count, U32 repeat )
+    {
+        const U32 sample_rates[] = { 1000000, 10000000, 100000000, 500000000 };
+        const U32 bit_rates[] = { 1000, 9600, 19200, 100000, 1000000 };
+        const char* const impairment_names[] = { "ideal", "mild", "harsh" };
+
+        printf( "sample_rate,bit_rate,impairments,samples,edges,simulated_seconds,seconds,simulated_seconds_per_s,packets,"
+                "error_frames,decode_seconds,realtime_factor\n" );
+        for( U32 s = 0; s < 4; s += quick ? 3 : 1 )
+            for( U32 b = 0; b < 5; b += quick ? 4 : 1 )
+                for( U32 i = 0; i < 3; i += quick ? 2 : 1 )
+                {
+                    const U32 sample_rate = sample_rates[ s ];
+                    const U32 bit_rate = bit_rates[ b ];
+                    if( sample_rate < bit_rate * 4 )
+                        continue;
+
+                    const U64 target_sample = U64( frame_count ) * 120 * sample_rate / bit_rate;
+                    U64 samples = 0;
+                    U64 edges = 0;
+                    U64 packets = 0;
+                    U64 error_frames = 0;
+                    double best = 0;
+                    double best_decode = 0;
+                    for( U32 r = 0; r < repeat; r++ )
+                    {
+                        LINTestAnalyzer analyzer( sample_rate, bit_rate );
+                        analyzer.Settings().mSimulationImpairments = LINAnalyzerSettings::tLINSimulationImpairments( i );
+                        SimulationChannelDescriptor* channel;
+                        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                        analyzer.GenerateSimulationData( target_sample, sample_rate, &channel );
+                        double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+
+                        // the capture is already long enough, so this only loads it.
+                        analyzer.LoadSimulation( target_sample );
+                        start = std::chrono::steady_clock::now();
+                        analyzer.RunToCompletion();
+                        double decode_seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+
+                        if( r == 0 || seconds < best )
+                            best = seconds;
+                        if( r == 0 || decode_seconds < best_decode )
+                            best_decode = decode_seconds;
+                        samples = channel->GetCurrentSampleNumber();
+                        edges = channel->mEdges.size();
+                        packets = analyzer.Results().GetNumPackets();
+                        error_frames = 0;
+                        for( U64 f = 0; f < analyzer.Results().GetNumFrames(); f++ )
+                        {
+                            if( analyzer.Results().GetFrame( f ).mFlags != 0 )
+                                ++error_frames;
+                        }
+                    }
+
+                    const double seconds = best > 0 ? best : 1e-9;
+                    const double decode_seconds = best_decode > 0 ? best_decode : 1e-9;
+                    const double simulated_seconds = double( samples ) / sample_rate;
+                    printf( "%u,%u,%s,%llu,%llu,%.3f,%.6f,%.0f,%llu,%llu,%.6f,%.1f\n", sample_rate, bit_rate, impairment_names[ i ],
+                            ( unsigned long long )samples, ( unsigned long long )edges, simulated_seconds, seconds,
+                            simulated_seconds / seconds, ( unsigned long long )packets, ( unsigned long long )error_frames,
+                            decode_seconds, simulated_seconds / decode_seconds );
+                    fflush( stdout );
+                }
+    }
+}
+
+int main( int argc, char** argv )
+{
+    bool quick = false;
+    bool simulation = false;
+    bool checksum = false;
+    bool text = false;
+    bool export_files = false;
+    U32 frame_count = 2000;
+    U32 repeat = 3;
+    for( int i = 1; i < argc; i++ )
+    {
+        if( strcmp( argv[ i ], "--quick" ) == 0 )
+            quick = true;
+        else if( strcmp( argv[ i ], "--simulation" ) == 0 )
+            simulation = true;
+        else if( strcmp( argv[ i ], "--checksum" ) == 0 )
+            checksum = true;
+        else if( strcmp( argv[ i ], "--text" ) == 0 )
+            text = true;
+        else if( strcmp( argv[ i ], "--export" ) == 0 )
+            export_files = true;
+        else if( strcmp( argv[ i ], "--frames" ) == 0 && i + 1 < argc )
+            frame_count = U32( strtoul( argv[ ++i ], NULL, 10 ) );
+        else if( strcmp( argv[ i ], "--repeat" ) == 0 && i + 1 < argc )
+            repeat = U32( strtoul( argv[ ++i ], NULL, 10 ) );
+        else
+        {
+            fprintf( stderr, "usage: %s [--simulation | --checksum | --text | --export] [--quick] [--frames N] [--repeat N]\n",
+                     argv[ 0 ] );
+            return 2;
+        }
+    }
+    if( quick )
+    {
+        frame_count = 100;
+        repeat = 1;
+    }
+    if( frame_count == 0 || repeat == 0 )
+    {
+        fprintf( stderr, "--frames and --repeat must be at least 1\n" );
+        return 2;
+    }
+
+    if( export_files )
+        ExportSweep( frame_count, repeat );
+    else if( text )
+        TextSweep( frame_count, repeat );
+    else if( checksum )
+        ChecksumSweep( frame_count, repeat );
+    else if( simulation )
+        SimulationSweep( quick, frame_count, repeat );
+    else
+        DecoderSweep( quick, frame_count, repeat );
+    return 0;
+}
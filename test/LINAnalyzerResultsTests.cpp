@@ -0,0 +1,304 @@
+#include "LINTest.h"
+#include "LINTestHarness.h"
+#include "LINChecksum.h"
+#include "LINFrameTableReader.h"
+#include "LINFrameTableWriter.h"
+#include <fstream>
+#include <sstream>
+#include <stdio.h>
+#include <string.h>
+
+namespace
+{
+    const U32 SampleRate = 1000000;
+    const U32 BitRate = 19200;
+    const U8 Data[] = { 0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0xDE, 0xF0 };
+
+    void DecodeFrame( LINTestAnalyzer& analyzer, bool checksum_error )
+    {
+        LINWaveform waveform( SampleRate, BitRate );
+        waveform.Idle( 20 );
+        waveform.Frame( 0x10, Data, 8, true, checksum_error );
+        waveform.Idle( 20 );
+        analyzer.Run( waveform );
+    }
+
+    // index of the first frame of the given type.
+    U64 FindFrame( LINTestAnalyzer& analyzer, LINDecoder::tLINFrameState type )
+    {
+        for( U64 i = 0; i < analyzer.Results().GetNumFrames(); i++ )
+        {
+            if( analyzer.Results().GetFrame( i ).mType == type )
+                return i;
+        }
+        return 0;
+    }
+
+    // the frame table records of the LIN frames the decoder reports, as the batch decoder writes them.
+    class RecordSink : public LINDecoderSink
+    {
+      public:
+        virtual void OnMarker( U64 /*sample*/, LINDecoder::tLINMarker /*marker*/ )
+        {
+        }
+
+        virtual void OnInterByteSpace( S64 /*starting_sample*/, S64 /*ending_sample*/ )
+        {
+        }
+
+        virtual void OnField( const LINDecoder::Field& /*field*/ )
+        {
+        }
+
+        virtual void OnLINFrame( const LINDecoder::LINFrame& lin_frame )
+        {
+            LINFrameTableRecord record;
+            LINFrameTableWriter::MakeRecord( lin_frame, record );
+            mRecords.push_back( record );
+        }
+
+        std::vector<LINFrameTableRecord> mRecords;
+    };
+
+    // decodes 5000 frames into the waveform, every 7th with a bad checksum, and exports them as a frame table. That is
+    // enough frames for the reader to go through several blocks of each column.
+    void ExportFrameTable( const char* path, LINWaveform& waveform )
+    {
+        waveform.Idle( 20 );
+        for( U32 i = 0; i < 5000; i++ )
+        {
+            waveform.Frame( U8( i % 60 ), Data, 1 + i % 8, true, i % 7 == 0 );
+            waveform.Idle( 3 );
+        }
+        waveform.Idle( 20 );
+        LINTestAnalyzer analyzer( SampleRate, BitRate );
+        analyzer.Run( waveform );
+        analyzer.Results().GenerateExportFile( path, Hexadecimal, LINAnalyzerSettings::BinaryExport );
+    }
+
+    std::string ReadFile( const char* path )
+    {
+        std::ifstream file( path, std::ios::in | std::ios::binary );
+        std::stringstream text;
+        text << file.rdbuf();
+        return text.str();
+    }
+}
+
+LIN_TEST( BubbleText )
+{
+    LINTestAnalyzer analyzer( SampleRate, BitRate );
+    DecodeFrame( analyzer, false );
+    Channel channel = analyzer.Settings().mInputChannel;
+    LINAnalyzerResults& results = analyzer.Results();
+
+    results.GenerateBubbleText( FindFrame( analyzer, LINDecoder::headerPID ), channel, Hexadecimal );
+    LIN_CHECK_EQUAL( 3, results.mResultStrings.size() );
+    if( results.mResultStrings.size() == 3 )
+    {
+        LIN_CHECK( results.mResultStrings[ 0 ] == "0x10" );
+        LIN_CHECK( results.mResultStrings[ 1 ] == "PID: 0x10" );
+        LIN_CHECK( results.mResultStrings[ 2 ] == "Protected ID: 0x10" );
+    }
+
+    results.GenerateBubbleText( FindFrame( analyzer, LINDecoder::responseData ), channel, Decimal );
+    LIN_CHECK_EQUAL( 3, results.mResultStrings.size() );
+    if( results.mResultStrings.size() == 3 )
+    {
+        LIN_CHECK( results.mResultStrings[ 0 ] == "52" );
+        LIN_CHECK( results.mResultStrings[ 1 ] == "D1: 52" );
+        LIN_CHECK( results.mResultStrings[ 2 ] == "Data 1: 52" );
+    }
+
+    results.GenerateFrameTabularText( FindFrame( analyzer, LINDecoder::headerBreak ), Hexadecimal );
+    LIN_CHECK_EQUAL( 1, results.mTabularText.size() );
+    if( results.mTabularText.size() == 1 )
+        LIN_CHECK( results.mTabularText[ 0 ] == "Header Break" );
+}
+
+LIN_TEST( ErrorText )
+{
+    LINTestAnalyzer analyzer( SampleRate, BitRate );
+    DecodeFrame( analyzer, true );
+    Channel channel = analyzer.Settings().mInputChannel;
+    LINAnalyzerResults& results = analyzer.Results();
+
+    U64 checksum = FindFrame( analyzer, LINDecoder::responseChecksum );
+    char number[ 8 ];
+    snprintf( number, sizeof( number ), "0x%02X", U32( results.GetFrame( checksum ).mData1 ) );
+
+    results.GenerateBubbleText( checksum, channel, Hexadecimal );
+    LIN_CHECK_EQUAL( 3, results.mResultStrings.size() );
+    if( results.mResultStrings.size() == 3 )
+    {
+        LIN_CHECK( results.mResultStrings[ 0 ] == "!CHK!" );
+        LIN_CHECK( results.mResultStrings[ 1 ] == std::string( "!CHK ERR: " ) + number );
+        LIN_CHECK( results.mResultStrings[ 2 ] == std::string( "!Checksum mismatch: " ) + number );
+    }
+
+    results.GenerateFrameTabularText( checksum, Hexadecimal );
+    LIN_CHECK_EQUAL( 1, results.mTabularText.size() );
+    if( results.mTabularText.size() == 1 )
+        LIN_CHECK( results.mTabularText[ 0 ] == "!CHK!" );
+
+    char flags[ 64 ];
+    LIN_CHECK( results.FormatFlags( LINDecoder::byteFramingError | LINDecoder::pidParityError, flags, sizeof( flags ) ) );
+    LIN_CHECK( std::string( flags ) == "!FRAME!PARITY!" );
+    LIN_CHECK( !results.FormatFlags( 0, flags, sizeof( flags ) ) );
+}
+
+LIN_TEST( TextExport )
+{
+    LINTestAnalyzer analyzer( SampleRate, BitRate );
+    DecodeFrame( analyzer, false );
+
+    const char* path = "lin_analyzer_tests.csv";
+    analyzer.Results().GenerateExportFile( path, Hexadecimal, LINAnalyzerSettings::TextExport );
+    std::string text = ReadFile( path );
+    remove( path );
+
+    // times are those of the start bits: the break at 20 bits, the sync 14 bits later, then a byte every 10 bits.
+    LIN_CHECK( text == "T.BREAK,BREAK,T.SYNC,SYNC,T.PID,PID,T.D,Dn...\n"
+                       "0.001042,0x00,0.001771,0x55,0.002292,0x10,0.002813,0x12,0.003333,0x34,0.003854,0x56,0.004375,0x78,"
+                       "0.004896,0x9A,0.005417,0xBC,0.005938,0xDE,0.006458,0xF0,0.006979,0x73\n" );
+}
+
+LIN_TEST( BinaryExport )
+{
+    LINTestAnalyzer analyzer( SampleRate, BitRate );
+    DecodeFrame( analyzer, false );
+
+    const char* path = "lin_analyzer_tests.linbin";
+    analyzer.Results().GenerateExportFile( path, Hexadecimal, LINAnalyzerSettings::BinaryExport );
+    std::string binary = ReadFile( path );
+    remove( path );
+
+    LIN_CHECK( binary.size() > 96 );
+    LIN_CHECK( binary.compare( 0, 8, "LINFRAME" ) == 0 );
+}
+
+LIN_TEST( PcapExport )
+{
+    LINTestAnalyzer analyzer( SampleRate, BitRate );
+    DecodeFrame( analyzer, false );
+
+    const char* path = "lin_analyzer_tests.pcap";
+    analyzer.Results().GenerateExportFile( path, Hexadecimal, LINAnalyzerSettings::PcapExport );
+    std::string pcap = ReadFile( path );
+    remove( path );
+
+    // the file header, then one record of 16 bytes, the 8 byte LIN pseudo-header and 8 data bytes.
+    LIN_CHECK_EQUAL( 24 + 16 + 8 + 8, pcap.size() );
+}
+
+LIN_TEST( FrameTableReader )
+{
+    const char* path = "lin_analyzer_tests.linbin";
+    LINWaveform waveform( SampleRate, BitRate );
+    ExportFrameTable( path, waveform );
+    LINFrameTableReader reader;
+    LIN_CHECK( reader.Open( path ) );
+    LIN_CHECK_EQUAL( 5000, reader.GetRecordCount() );
+    LIN_CHECK_EQUAL( SampleRate, reader.GetSampleRate() );
+
+    // the export holds the same records as the LIN frames the decoder reported while decoding, which is what lin_decode
+    // writes.
+    const std::vector<U64>& edges = waveform.GetEdges();
+    LINEdgeList source( true, &edges[ 0 ], edges.size(), waveform.GetSample() );
+    LINDecoder::Settings settings;
+    settings.mSampleRate = SampleRate;
+    settings.mBitRate = BitRate;
+    RecordSink sink;
+    LINDecoder decoder;
+    decoder.Run( &source, &sink, settings );
+    LIN_CHECK_EQUAL( 5000, sink.mRecords.size() );
+
+    LINFrameTableReader::Record record;
+    U32 mismatches = 0;
+    for( size_t i = 0; i < sink.mRecords.size(); i++ )
+    {
+        const LINFrameTableRecord& expected = sink.mRecords[ i ];
+        LIN_CHECK( reader.Next( record ) );
+        LIN_CHECK_EQUAL( expected.mTimestamp, record.mTimestamp );
+        LIN_CHECK_EQUAL( expected.mIdentifier, record.mIdentifier );
+        LIN_CHECK_EQUAL( expected.mLength, record.mLength );
+        LIN_CHECK( memcmp( expected.mData, record.mData, 8 ) == 0 );
+        LIN_CHECK_EQUAL( expected.mChecksum, record.mChecksum );
+        LIN_CHECK_EQUAL( expected.mFlags, record.mFlags );
+        if( record.mFlags & LINDecoder::checksumMismatch )
+            ++mismatches;
+    }
+    LIN_CHECK_EQUAL( 715, mismatches ); // every 7th frame, whether or not the decoder saw its checksum as one.
+    LIN_CHECK( !reader.Next( record ) );
+    reader.Close();
+    remove( path );
+
+    LIN_CHECK( !reader.Open( "lin_analyzer_tests.missing" ) );
+}
+
+// the index lists number records in 32 bits, so a table with more records than that isn't started.
+LIN_TEST( FrameTableWriterRejectsTooManyRecords )
+{
+    const char* path = "lin_analyzer_tests.linbin";
+    remove( path );
+    U64 id_counts[ LINFrameTableIndexEntries ] = { 0 };
+    id_counts[ 0 ] = LINFrameTableMaxRecords;
+    id_counts[ LINFrameTableIndexEntries - 1 ] = 1;
+    LINFrameTableWriter writer;
+    LIN_CHECK( !writer.Open( path, SampleRate, 0, id_counts ) );
+    LIN_CHECK( ReadFile( path ).empty() );
+}
+
+// the batch check agrees with the checksum errors the decoder recorded, from the start of the table or from part way
+// through a block. The last byte of each response is recorded as its checksum, so every wrong one is found.
+LIN_TEST( FrameTableVerifyChecksums )
+{
+    const char* path = "lin_analyzer_tests.linbin";
+    LINWaveform waveform( SampleRate, BitRate );
+    ExportFrameTable( path, waveform );
+
+    LINFrameTableReader reader;
+    LINFrameTableReader::Record record;
+    U64 with_checksum[ 2 ] = { 0, 0 }; // all records, and those after the first 1000.
+    U64 flagged[ 2 ] = { 0, 0 };
+    LIN_CHECK( reader.Open( path ) );
+    for( U32 i = 0; reader.Next( record ); i++ )
+    {
+        if( ( record.mFlags & LINFrameTableNoChecksum ) != 0 )
+            continue;
+        const U32 flagged_here = ( record.mFlags & LINDecoder::checksumMismatch ) != 0 ? 1 : 0;
+        ++with_checksum[ 0 ];
+        flagged[ 0 ] += flagged_here;
+        if( i >= 1000 )
+        {
+            ++with_checksum[ 1 ];
+            flagged[ 1 ] += flagged_here;
+        }
+    }
+    LIN_CHECK_EQUAL( 715, flagged[ 0 ] );
+    LIN_CHECK_EQUAL( 5000, with_checksum[ 0 ] );
+
+    bool enhanced_ids[ 64 ];
+    for( U32 identifier = 0; identifier < 64; identifier++ )
+        enhanced_ids[ identifier ] = LINChecksum::IsEnhanced( 2.0, U8( identifier ) );
+
+    U64 checked;
+    LIN_CHECK( reader.Open( path ) );
+    LIN_CHECK_EQUAL( flagged[ 0 ], reader.VerifyChecksums( enhanced_ids, checked ) );
+    LIN_CHECK_EQUAL( with_checksum[ 0 ], checked );
+
+    LIN_CHECK( reader.Open( path ) );
+    for( U32 i = 0; i < 1000; i++ )
+        reader.Next( record );
+    LIN_CHECK_EQUAL( flagged[ 1 ], reader.VerifyChecksums( enhanced_ids, checked ) );
+    LIN_CHECK_EQUAL( with_checksum[ 1 ], checked );
+    LIN_CHECK( !reader.Next( record ) );
+
+    // the wrong model fails nearly every frame.
+    for( U32 identifier = 0; identifier < 64; identifier++ )
+        enhanced_ids[ identifier ] = false;
+    LIN_CHECK( reader.Open( path ) );
+    LIN_CHECK( reader.VerifyChecksums( enhanced_ids, checked ) > checked * 9 / 10 );
+    reader.Close();
+    remove( path );
+}
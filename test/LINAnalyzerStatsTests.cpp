@@ -0,0 +1,103 @@
+#include "LINAnalyzerStats.h"
+
+// the counters only exist in LIN_ANALYZER_STATS builds.
+#if LIN_ANALYZER_STATS
+
+#include "LINTest.h"
+#include "LINTestHarness.h"
+#include "LINProtectedIdentifier.h"
+#include <fstream>
+#include <sstream>
+#include <stdio.h>
+
+namespace
+{
+    const U32 SampleRate = 1000000;
+    const U32 BitRate = 19200;
+    const U8 Data[] = { 0x12, 0x34, 0x56, 0x78 };
+
+    // three frames; the second has a PID with bad parity, and no response.
+    LINWaveform ResyncWaveform()
+    {
+        LINWaveform waveform( SampleRate, BitRate );
+        waveform.Idle( 20 );
+        waveform.Frame( 0x10, Data, 4, true );
+        waveform.Idle( 4 );
+        waveform.Break();
+        waveform.Byte( 0x55 );
+        waveform.Byte( LINProtectedIdentifier( 0x11 ) ^ 0x80 );
+        waveform.Idle( 4 );
+        waveform.Frame( 0x12, Data, 4, true );
+        waveform.Idle( 20 );
+        return waveform;
+    }
+
+    S64 Counter( const FrameV2& frame, const char* name )
+    {
+        const FrameV2Entry* entry = frame.Find( name );
+        LIN_CHECK( entry != NULL );
+        return entry != NULL ? entry->mInteger : -1;
+    }
+}
+
+LIN_TEST( StatsRecordAtEndOfCapture )
+{
+    LINTestAnalyzer analyzer( SampleRate, BitRate );
+    analyzer.Run( ResyncWaveform() );
+
+    LINAnalyzerResults& results = analyzer.Results();
+    LIN_CHECK( !results.mFramesV2.empty() && results.mFramesV2.back().mType == "lin_stats" );
+    if( results.mFramesV2.empty() )
+        return;
+
+    // zero width, after the last frame it counts.
+    LIN_CHECK_EQUAL( results.mFramesV2.back().mStartingSample, results.mFramesV2.back().mEndingSample );
+    LIN_CHECK( results.mFramesV2.back().mStartingSample >= U64( results.GetFrame( results.GetNumFrames() - 1 ).mEndingSampleInclusive ) );
+
+    const FrameV2& stats = results.mFramesV2.back().mFrame;
+    LIN_CHECK_EQUAL( analyzer.ByteFrames().size(), Counter( stats, "fields" ) );
+    LIN_CHECK_EQUAL( results.GetNumFrames(), Counter( stats, "frames" ) );
+    LIN_CHECK_EQUAL( results.mMarkers.size(), Counter( stats, "markers" ) );
+    LIN_CHECK_EQUAL( 3, Counter( stats, "packets" ) );
+    LIN_CHECK_EQUAL( 1, Counter( stats, "resyncs" ) );
+    LIN_CHECK_EQUAL( 0, Counter( stats, "framing_errors" ) );
+    LIN_CHECK( Counter( stats, "break_hunts" ) >= 3 );
+    LIN_CHECK( Counter( stats, "edges" ) > 0 );
+    LIN_CHECK( stats.Find( "time_header_pid" ) != NULL );
+    LIN_CHECK( stats.Find( "run_time" ) != NULL );
+}
+
+LIN_TEST( StatsCountFramingErrors )
+{
+    LINWaveform waveform( SampleRate, BitRate );
+    waveform.Idle( 20 );
+    waveform.Break();
+    waveform.Byte( 0x55 );
+    waveform.Byte( LINProtectedIdentifier( 0x10 ) );
+    waveform.Byte( 0x12, false );
+    waveform.Idle( 20 );
+
+    LINTestAnalyzer analyzer( SampleRate, BitRate );
+    analyzer.Run( waveform );
+    LIN_CHECK_EQUAL( 1, analyzer.GetStats().mCounters[ LINAnalyzerStats::FramingErrors ] );
+}
+
+LIN_TEST( StatsExport )
+{
+    LINTestAnalyzer analyzer( SampleRate, BitRate );
+    analyzer.Run( ResyncWaveform() );
+
+    const char* path = "lin_analyzer_stats.csv";
+    analyzer.Results().GenerateExportFile( path, Decimal, LINAnalyzerSettings::StatsExport );
+    std::ifstream file( path );
+    std::stringstream text;
+    text << file.rdbuf();
+    file.close();
+    remove( path );
+
+    LIN_CHECK( text.str().compare( 0, 18, "name,value\nfields," ) == 0 );
+    LIN_CHECK( text.str().find( "\nresyncs,1\n" ) != std::string::npos );
+    LIN_CHECK( text.str().find( "\ntime_checksum," ) != std::string::npos );
+}
+
+#endif // LIN_ANALYZER_STATS
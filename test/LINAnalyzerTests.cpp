@@ -0,0 +1,371 @@
+#include "LINTest.h"
+#include "LINTestHarness.h"
+#include "LINProtectedIdentifier.h"
+#include <stdio.h>
+#include <string.h>
+
+namespace
+{
+    const U32 SampleRate = 1000000;
+    const U32 BitRate = 19200;
+    const U8 Identifier = 0x10;
+    const U8 Data[] = { 0x12, 0x34, 0x56, 0x78 };
+
+    // without an LDF, a wrong checksum can only be told from data once a response reaches 8 bytes.
+    const U8 LongData[] = { 0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0xDE, 0xF0 };
+
+    LINWaveform FrameWaveform( U8 identifier, const U8* data, U32 length, bool enhanced, bool checksum_error = false )
+    {
+        LINWaveform waveform( SampleRate, BitRate );
+        waveform.Idle( 20 );
+        waveform.Frame( identifier, data, length, enhanced, checksum_error );
+        waveform.Idle( 20 );
+        return waveform;
+    }
+
+    // break, sync, PID, the data bytes and the checksum of one clean frame.
+    void CheckFrame( const std::vector<Frame>& frames, size_t first, U8 identifier, const U8* data, U32 length )
+    {
+        LIN_CHECK( frames.size() >= first + length + 4 );
+        if( frames.size() < first + length + 4 )
+            return;
+
+        LIN_CHECK_EQUAL( LINDecoder::headerBreak, frames[ first ].mType );
+        LIN_CHECK_EQUAL( LINDecoder::headerSync, frames[ first + 1 ].mType );
+        LIN_CHECK_EQUAL( 0x55, frames[ first + 1 ].mData1 );
+        LIN_CHECK_EQUAL( LINDecoder::headerPID, frames[ first + 2 ].mType );
+        LIN_CHECK_EQUAL( LINProtectedIdentifier( identifier ), frames[ first + 2 ].mData1 );
+        for( U32 i = 0; i < length; i++ )
+        {
+            const Frame& frame = frames[ first + 3 + i ];
+            LIN_CHECK_EQUAL( i == 0 ? LINDecoder::responseDataZero : LINDecoder::responseData, frame.mType );
+            LIN_CHECK_EQUAL( data[ i ], frame.mData1 );
+            LIN_CHECK_EQUAL( i + 1, frame.mData2 );
+        }
+        LIN_CHECK_EQUAL( LINDecoder::responseChecksum, frames[ first + 3 + length ].mType );
+        for( U32 i = 0; i < length + 4; i++ )
+            LIN_CHECK_EQUAL( 0, frames[ first + i ].mFlags );
+    }
+
+    U32 CountFramesV2( LINTestAnalyzer& analyzer, const char* type )
+    {
+        U32 count = 0;
+        for( size_t i = 0; i < analyzer.Results().mFramesV2.size(); i++ )
+        {
+            if( analyzer.Results().mFramesV2[ i ].mType == type )
+                ++count;
+        }
+        return count;
+    }
+
+    const char* const DescriptionFileText = "LIN_description_file;\n"
+                                            "LIN_protocol_version = \"2.1\";\n"
+                                            "Nodes { Master: CEM, 5 ms, 0.1 ms; Slaves: LSM; }\n"
+                                            "Frames {\n"
+                                            "  LSM_Frm1: 0x10, LSM, 2 { LeftSwitch, 8; }\n"
+                                            "}\n"
+                                            "Node_attributes { LSM { LIN_protocol = \"1.3\"; } }\n";
+}
+
+LIN_TEST( DecodesEnhancedFrame )
+{
+    LINWaveform waveform = FrameWaveform( Identifier, Data, 4, true );
+    LINTestAnalyzer analyzer( SampleRate, BitRate );
+    analyzer.Run( waveform );
+
+    std::vector<Frame> frames = analyzer.ByteFrames();
+    LIN_CHECK_EQUAL( 8, frames.size() );
+    CheckFrame( frames, 0, Identifier, Data, 4 );
+
+    // the break starts 20 bits in; every other field is one 10 bit byte after the one before.
+    LIN_CHECK_EQUAL( waveform.GetEdges()[ 0 ], frames[ 0 ].mStartingSampleInclusive );
+    LIN_CHECK( frames[ 7 ].mEndingSampleInclusive < S64( waveform.GetSample() ) );
+
+    // one packet, from the break to the checksum.
+    LIN_CHECK_EQUAL( 1, analyzer.Results().GetNumPackets() );
+    U64 first_frame;
+    U64 last_frame;
+    analyzer.Results().GetFramesContainedInPacket( 0, &first_frame, &last_frame );
+    LIN_CHECK_EQUAL( LINDecoder::headerBreak, analyzer.Results().GetFrame( first_frame ).mType );
+    LIN_CHECK_EQUAL( LINDecoder::responseChecksum, analyzer.Results().GetFrame( last_frame ).mType );
+}
+
+LIN_TEST( MarksEveryBitByDefault )
+{
+    LINTestAnalyzer analyzer( SampleRate, BitRate );
+    analyzer.Run( FrameWaveform( Identifier, Data, 4, true ) );
+
+    // 7 bytes of 8 data bits, and the 13 break bits; a start bit for each byte and a stop bit for each field.
+    LIN_CHECK_EQUAL( 7 * 8 + 13, analyzer.CountMarkers( AnalyzerResults::One ) + analyzer.CountMarkers( AnalyzerResults::Zero ) );
+    LIN_CHECK_EQUAL( 7, analyzer.CountMarkers( AnalyzerResults::Start ) );
+    LIN_CHECK_EQUAL( 8, analyzer.CountMarkers( AnalyzerResults::Stop ) );
+    LIN_CHECK_EQUAL( 0, analyzer.CountMarkers( AnalyzerResults::ErrorSquare ) );
+}
+
+LIN_TEST( MarkerDensity )
+{
+    LINTestAnalyzer start_stop( SampleRate, BitRate );
+    start_stop.Settings().mMarkerDensity = LINAnalyzerSettings::StartStopMarkers;
+    start_stop.Run( FrameWaveform( Identifier, Data, 4, true ) );
+    LIN_CHECK_EQUAL( 0, start_stop.CountMarkers( AnalyzerResults::One ) + start_stop.CountMarkers( AnalyzerResults::Zero ) );
+    LIN_CHECK_EQUAL( 7, start_stop.CountMarkers( AnalyzerResults::Start ) );
+
+    LINTestAnalyzer errors_only( SampleRate, BitRate );
+    errors_only.Settings().mMarkerDensity = LINAnalyzerSettings::ErrorMarkersOnly;
+    errors_only.Run( FrameWaveform( Identifier, Data, 4, true ) );
+    LIN_CHECK_EQUAL( 0, errors_only.Results().mMarkers.size() );
+    LIN_CHECK_EQUAL( 8, errors_only.ByteFrames().size() );
+}
+
+LIN_TEST( ChecksumModelFollowsVersion )
+{
+    // a classic checksum is right for LIN 1.x and wrong for LIN 2.x.
+    LINTestAnalyzer version1( SampleRate, BitRate );
+    version1.Settings().mLINVersion = 1.0;
+    version1.Run( FrameWaveform( Identifier, Data, 4, false ) );
+    std::vector<Frame> frames = version1.ByteFrames();
+    LIN_CHECK_EQUAL( 8, frames.size() );
+    CheckFrame( frames, 0, Identifier, Data, 4 );
+
+    LINTestAnalyzer version2( SampleRate, BitRate );
+    version2.Run( FrameWaveform( Identifier, LongData, 8, false ) );
+    frames = version2.ByteFrames();
+    LIN_CHECK_EQUAL( 12, frames.size() );
+    LIN_CHECK_EQUAL( LINDecoder::checksumMismatch, frames.back().mFlags );
+}
+
+LIN_TEST( DiagnosticFramesUseClassicChecksum )
+{
+    const U8 request[] = { 0x7F, 0x06, 0xB2, 0x00, 0xFF, 0x7F, 0xFF, 0xFF };
+    LINTestAnalyzer analyzer( SampleRate, BitRate );
+    analyzer.Run( FrameWaveform( 0x3C, request, 8, false ) );
+
+    std::vector<Frame> frames = analyzer.ByteFrames();
+    LIN_CHECK_EQUAL( 12, frames.size() );
+    CheckFrame( frames, 0, 0x3C, request, 8 );
+}
+
+LIN_TEST( ChecksumMismatchIsFlagged )
+{
+    LINTestAnalyzer analyzer( SampleRate, BitRate );
+    analyzer.Run( FrameWaveform( Identifier, LongData, 8, true, true ) );
+
+    std::vector<Frame> frames = analyzer.ByteFrames();
+    LIN_CHECK_EQUAL( 12, frames.size() );
+    LIN_CHECK_EQUAL( LINDecoder::responseChecksum, frames.back().mType );
+    LIN_CHECK_EQUAL( LINDecoder::checksumMismatch, frames.back().mFlags );
+}
+
+LIN_TEST( DataByteMatchingChecksumIsNotTheEnd )
+{
+    // 0x9D is the enhanced checksum of the PID and 0x12, but more data follows it.
+    const U8 data[] = { 0x12, 0x9D, 0x01, 0x02 };
+    LIN_CHECK_EQUAL( 0x9D, LINEnhancedChecksumEngine::Compute( LINProtectedIdentifier( Identifier ), data, 1 ) );
+
+    LINTestAnalyzer analyzer( SampleRate, BitRate );
+    analyzer.Run( FrameWaveform( Identifier, data, 4, true ) );
+
+    std::vector<Frame> frames = analyzer.ByteFrames();
+    LIN_CHECK_EQUAL( 8, frames.size() );
+    CheckFrame( frames, 0, Identifier, data, 4 );
+}
+
+LIN_TEST( BackToBackFrames )
+{
+    LINWaveform waveform( SampleRate, BitRate );
+    waveform.Idle( 20 );
+    for( U32 i = 0; i < 8; i++ )
+    {
+        waveform.Frame( U8( i ), Data, 1 + i % 4, true );
+        waveform.Idle( 5 );
+    }
+    waveform.Idle( 20 );
+
+    LINTestAnalyzer analyzer( SampleRate, BitRate );
+    analyzer.Run( waveform );
+
+    std::vector<Frame> frames = analyzer.ByteFrames();
+    size_t first = 0;
+    for( U32 i = 0; i < 8; i++ )
+    {
+        CheckFrame( frames, first, U8( i ), Data, 1 + i % 4 );
+        first += 1 + i % 4 + 4;
+    }
+    LIN_CHECK_EQUAL( first, frames.size() );
+    LIN_CHECK_EQUAL( 8, analyzer.Results().GetNumPackets() );
+}
+
+LIN_TEST( BadSyncIsFlagged )
+{
+    LINWaveform waveform( SampleRate, BitRate );
+    waveform.Idle( 20 );
+    waveform.Break();
+    waveform.Byte( 0x54 );
+    waveform.Idle( 20 );
+    waveform.Frame( Identifier, Data, 4, true );
+    waveform.Idle( 20 );
+
+    LINTestAnalyzer analyzer( SampleRate, BitRate );
+    analyzer.Run( waveform );
+
+    std::vector<Frame> frames = analyzer.ByteFrames();
+    LIN_CHECK_EQUAL( 10, frames.size() );
+    LIN_CHECK_EQUAL( LINDecoder::headerSyncExpected, frames[ 1 ].mFlags );
+    CheckFrame( frames, 2, Identifier, Data, 4 );
+}
+
+LIN_TEST( PIDParityErrorSkipsTheResponse )
+{
+    LINWaveform waveform( SampleRate, BitRate );
+    waveform.Idle( 20 );
+    waveform.Break();
+    waveform.Byte( 0x55 );
+    waveform.Byte( LINProtectedIdentifier( Identifier ) ^ 0x80 );
+    for( U32 i = 0; i < 4; i++ )
+        waveform.Byte( Data[ i ] );
+    waveform.Byte( 0x00 );
+    waveform.Idle( 20 );
+    waveform.Frame( Identifier, Data, 4, true );
+    waveform.Idle( 20 );
+
+    LINTestAnalyzer analyzer( SampleRate, BitRate );
+    analyzer.Run( waveform );
+
+    // the bytes after the bad PID aren't decoded; the next frame is.
+    std::vector<Frame> frames = analyzer.ByteFrames();
+    LIN_CHECK_EQUAL( 11, frames.size() );
+    LIN_CHECK_EQUAL( LINDecoder::headerPID, frames[ 2 ].mType );
+    LIN_CHECK_EQUAL( LINDecoder::pidParityError, frames[ 2 ].mFlags );
+    CheckFrame( frames, 3, Identifier, Data, 4 );
+
+    LIN_CHECK_EQUAL( 2, CountFramesV2( analyzer, "header_pid" ) );
+    const FrameV2* pid = NULL;
+    for( size_t i = 0; i < analyzer.Results().mFramesV2.size() && pid == NULL; i++ )
+    {
+        if( analyzer.Results().mFramesV2[ i ].mType == "header_pid" )
+            pid = &analyzer.Results().mFramesV2[ i ].mFrame;
+    }
+    LIN_CHECK( pid != NULL && pid->Find( "pid_parity_error" ) != NULL );
+}
+
+LIN_TEST( FramingErrorIsFlagged )
+{
+    LINWaveform waveform( SampleRate, BitRate );
+    waveform.Idle( 20 );
+    waveform.Break();
+    waveform.Byte( 0x55 );
+    waveform.Byte( LINProtectedIdentifier( Identifier ) );
+    waveform.Byte( 0x12, false );
+    waveform.Idle( 40 );
+
+    LINTestAnalyzer analyzer( SampleRate, BitRate );
+    analyzer.Run( waveform );
+
+    std::vector<Frame> frames = analyzer.ByteFrames();
+    LIN_CHECK( frames.size() >= 4 );
+    if( frames.size() >= 4 )
+        LIN_CHECK_EQUAL( LINDecoder::byteFramingError, frames[ 3 ].mFlags & LINDecoder::byteFramingError );
+    LIN_CHECK_EQUAL( 1, analyzer.CountMarkers( AnalyzerResults::ErrorSquare ) );
+}
+
+LIN_TEST( DescriptionFileSetsLengthAndChecksum )
+{
+    const char* path = "lin_analyzer_tests.ldf";
+    FILE* file = fopen( path, "wb" );
+    LIN_CHECK( file != NULL );
+    if( file == NULL )
+        return;
+    fwrite( DescriptionFileText, 1, strlen( DescriptionFileText ), file );
+    fclose( file );
+
+    // the LDF says LSM is a LIN 1.3 node sending 2 bytes, so its frame is classic even on a LIN 2.x bus. The byte that
+    // would match an enhanced checksum after the first data byte must not end the response either.
+    const U8 data[] = { 0x12, 0x34 };
+    LINTestAnalyzer analyzer( SampleRate, BitRate );
+    analyzer.Settings().mDescriptionFile = path;
+    analyzer.Run( FrameWaveform( Identifier, data, 2, false ) );
+    remove( path );
+
+    std::vector<Frame> frames = analyzer.ByteFrames();
+    LIN_CHECK_EQUAL( 6, frames.size() );
+    CheckFrame( frames, 0, Identifier, data, 2 );
+    LIN_CHECK( !analyzer.UsesEnhancedChecksum( Identifier ) );
+    LIN_CHECK( analyzer.UsesEnhancedChecksum( Identifier + 1 ) );
+}
+
+LIN_TEST( ByteFrameOutput )
+{
+    LINTestAnalyzer analyzer( SampleRate, BitRate );
+    analyzer.Run( FrameWaveform( Identifier, Data, 4, true ) );
+
+    LIN_CHECK_EQUAL( 8, analyzer.Results().mFramesV2.size() - CountFramesV2( analyzer, "lin_stats" ) );
+    LIN_CHECK_EQUAL( 1, CountFramesV2( analyzer, "header_break" ) );
+    LIN_CHECK_EQUAL( 1, CountFramesV2( analyzer, "header_sync" ) );
+    LIN_CHECK_EQUAL( 1, CountFramesV2( analyzer, "header_pid" ) );
+    LIN_CHECK_EQUAL( 4, CountFramesV2( analyzer, "data" ) );
+    LIN_CHECK_EQUAL( 1, CountFramesV2( analyzer, "checksum" ) );
+    LIN_CHECK_EQUAL( 0, CountFramesV2( analyzer, "lin_frame" ) );
+}
+
+LIN_TEST( LINFrameOutput )
+{
+    LINTestAnalyzer analyzer( SampleRate, BitRate );
+    analyzer.Settings().mFrameOutput = LINAnalyzerSettings::LINFrameOutput;
+    analyzer.Run( FrameWaveform( Identifier, Data, 4, true ) );
+
+    LIN_CHECK_EQUAL( 1, analyzer.Results().mFramesV2.size() - CountFramesV2( analyzer, "lin_stats" ) );
+    if( CountFramesV2( analyzer, "lin_frame" ) != 1 )
+        return;
+
+    const AnalyzerResults::FrameV2Record& record = analyzer.Results().mFramesV2[ 0 ];
+    LIN_CHECK( record.mType == "lin_frame" );
+    const FrameV2Entry* id = record.mFrame.Find( "id" );
+    const FrameV2Entry* data = record.mFrame.Find( "data" );
+    const FrameV2Entry* model = record.mFrame.Find( "checksum_model" );
+    LIN_CHECK( id != NULL && id->mInteger == Identifier );
+    LIN_CHECK( data != NULL && data->mBytes == std::vector<U8>( Data, Data + 4 ) );
+    LIN_CHECK( model != NULL && model->mString == "enhanced" );
+    LIN_CHECK( record.mFrame.Find( "checksum_mismatch" ) == NULL );
+}
+
+LIN_TEST( SampleAndBitRates )
+{
+    const U32 rates[][ 2 ] = { { 100000, 9600 }, { 2000000, 20000 }, { 16000000, 1000000 }, { 500000000, 19200 } };
+    for( U32 i = 0; i < sizeof( rates ) / sizeof( rates[ 0 ] ); i++ )
+    {
+        LINWaveform waveform( rates[ i ][ 0 ], rates[ i ][ 1 ] );
+        waveform.Idle( 20 );
+        waveform.Frame( Identifier, Data, 4, true );
+        waveform.Idle( 20 );
+
+        LINTestAnalyzer analyzer( rates[ i ][ 0 ], rates[ i ][ 1 ] );
+        analyzer.Run( waveform );
+
+        std::vector<Frame> frames = analyzer.ByteFrames();
+        LIN_CHECK_EQUAL( 8, frames.size() );
+        CheckFrame( frames, 0, Identifier, Data, 4 );
+    }
+}
+
+LIN_TEST( CommitPolicy )
+{
+    LINWaveform waveform( SampleRate, BitRate );
+    waveform.Idle( 20 );
+    for( U32 i = 0; i < 16; i++ )
+        waveform.Frame( Identifier, Data, 4, true );
+    waveform.Idle( 20 );
+
+    LINTestAnalyzer low_latency( SampleRate, BitRate );
+    low_latency.Run( waveform );
+    LINTestAnalyzer per_packet( SampleRate, BitRate );
+    per_packet.Settings().mCommitPolicy = LINAnalyzerSettings::CommitPerPacket;
+    per_packet.Run( waveform );
+    LINTestAnalyzer batched( SampleRate, BitRate );
+    batched.Settings().mCommitPolicy = LINAnalyzerSettings::CommitBatched;
+    batched.Run( waveform );
+
+    LIN_CHECK_EQUAL( 16 * 8, batched.ByteFrames().size() );
+    LIN_CHECK( per_packet.Results().mCommitCount < low_latency.Results().mCommitCount );
+    LIN_CHECK( batched.Results().mCommitCount < per_packet.Results().mCommitCount );
+    LIN_CHECK( batched.Results().mCommitCount >= 1 );
+}
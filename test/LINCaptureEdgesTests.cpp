@@ -0,0 +1,209 @@
+#include "LINTest.h"
+#include "LINTestHarness.h"
+#include "LINCaptureEdges.h"
+#include "LINDecoder.h"
+#include <string.h>
+#include <vector>
+
+namespace
+{
+    const U32 SampleRate = 1000000;
+    const U32 BitRate = 19200;
+    const U8 Data[] = { 0x01, 0x80, 0xFF, 0x00, 0x5A, 0xA5, 0x3C, 0xC3 };
+
+    class FieldSink : public LINDecoderSink
+    {
+      public:
+        virtual void OnMarker( U64 /*sample*/, LINDecoder::tLINMarker /*marker*/ )
+        {
+        }
+
+        virtual void OnInterByteSpace( S64 /*starting_sample*/, S64 /*ending_sample*/ )
+        {
+        }
+
+        virtual void OnField( const LINDecoder::Field& field )
+        {
+            mFields.push_back( field );
+        }
+
+        virtual void OnLINFrame( const LINDecoder::LINFrame& /*lin_frame*/ )
+        {
+        }
+
+        std::vector<LINDecoder::Field> mFields;
+    };
+
+    std::vector<LINDecoder::Field> Decode( LINEdgeSource& source )
+    {
+        LINDecoder::Settings settings;
+        settings.mSampleRate = SampleRate;
+        settings.mBitRate = BitRate;
+
+        FieldSink sink;
+        LINDecoder decoder;
+        decoder.Run( &source, &sink, settings );
+        return sink.mFields;
+    }
+
+    LINWaveform Traffic()
+    {
+        LINWaveform waveform( SampleRate, BitRate );
+        waveform.Idle( 20 );
+        waveform.Frame( 0x21, Data, 8, true );
+        waveform.Idle( 7.3 );
+        waveform.Frame( 0x3C, Data, 2, false, true );
+        waveform.Idle( 12 );
+        waveform.Break();
+        waveform.Byte( 0x55 );
+        waveform.Idle( 20 );
+        return waveform;
+    }
+
+    std::vector<LINDecoder::Field> DecodeEdgeList( const LINWaveform& waveform )
+    {
+        const std::vector<U64>& edges = waveform.GetEdges();
+        LINEdgeList source( true, &edges[ 0 ], edges.size(), waveform.GetSample() );
+        return Decode( source );
+    }
+
+    // the Logic 2 binary export of `waveform`, with the capture starting at `begin_time`.
+    std::vector<U8> TransitionTimesExport( const LINWaveform& waveform, double begin_time )
+    {
+        const std::vector<U64>& edges = waveform.GetEdges();
+        std::vector<U8> capture( LINTransitionTimes::HeaderSize + edges.size() * sizeof( double ) );
+        const U32 version = 0;
+        const U32 type = 0;
+        const U32 initial_state = 1;
+        const double end_time = begin_time + double( waveform.GetSample() ) / SampleRate;
+        const U64 edge_count = edges.size();
+        memcpy( &capture[ 0 ], "<SALEAE>", 8 );
+        memcpy( &capture[ 8 ], &version, 4 );
+        memcpy( &capture[ 12 ], &type, 4 );
+        memcpy( &capture[ 16 ], &initial_state, 4 );
+        memcpy( &capture[ 20 ], &begin_time, 8 );
+        memcpy( &capture[ 28 ], &end_time, 8 );
+        memcpy( &capture[ 36 ], &edge_count, 8 );
+        for( size_t i = 0; i < edges.size(); i++ )
+        {
+            const double time = begin_time + double( edges[ i ] ) / SampleRate;
+            memcpy( &capture[ LINTransitionTimes::HeaderSize + i * sizeof( double ) ], &time, sizeof( double ) );
+        }
+        return capture;
+    }
+
+    // one bit per sample, LSB first, idling high from the start.
+    std::vector<U8> SampleBits( const std::vector<U64>& edges, U64 samples )
+    {
+        std::vector<U8> capture( ( samples + 7 ) / 8 );
+        bool high = true;
+        size_t next_edge = 0;
+        for( U64 sample = 0; sample < capture.size() * 8; sample++ )
+        {
+            while( next_edge < edges.size() && edges[ next_edge ] <= sample )
+            {
+                high = !high;
+                ++next_edge;
+            }
+            if( high )
+                capture[ sample >> 3 ] |= U8( 1 << ( sample & 7 ) );
+        }
+        return capture;
+    }
+
+    void CheckSameFields( const std::vector<LINDecoder::Field>& expected, const std::vector<LINDecoder::Field>& fields )
+    {
+        LIN_CHECK_EQUAL( expected.size(), fields.size() );
+        for( size_t i = 0; i < expected.size() && i < fields.size(); i++ )
+        {
+            LIN_CHECK_EQUAL( expected[ i ].mStartingSample, fields[ i ].mStartingSample );
+            LIN_CHECK_EQUAL( expected[ i ].mEndingSample, fields[ i ].mEndingSample );
+            LIN_CHECK_EQUAL( expected[ i ].mType, fields[ i ].mType );
+            LIN_CHECK_EQUAL( expected[ i ].mData, fields[ i ].mData );
+            LIN_CHECK_EQUAL( expected[ i ].mFlags, fields[ i ].mFlags );
+        }
+    }
+}
+
+// a Logic 2 export decodes to the same fields as the edges it was made from, wherever the capture's clock starts.
+LIN_TEST( TransitionTimesDecodeLikeEdgeList )
+{
+    LINWaveform waveform = Traffic();
+    std::vector<LINDecoder::Field> expected = DecodeEdgeList( waveform );
+    LIN_CHECK_EQUAL( 20, expected.size() );
+
+    const double begin_times[] = { 0.0, -0.25, 1234.5 };
+    for( U32 i = 0; i < sizeof( begin_times ) / sizeof( begin_times[ 0 ] ); i++ )
+    {
+        std::vector<U8> capture = TransitionTimesExport( waveform, begin_times[ i ] );
+        LINTransitionTimes source;
+        LIN_CHECK( source.Open( &capture[ 0 ], capture.size(), SampleRate ) );
+        CheckSameFields( expected, Decode( source ) );
+    }
+}
+
+LIN_TEST( TransitionTimesRejectOtherFiles )
+{
+    std::vector<U8> capture = TransitionTimesExport( Traffic(), 0.0 );
+    LINTransitionTimes source;
+    LIN_CHECK( !source.Open( &capture[ 0 ], LINTransitionTimes::HeaderSize - 1, SampleRate ) );
+    LIN_CHECK( !source.Open( &capture[ 0 ], capture.size() - 1, SampleRate ) ); // the last transition is cut off.
+
+    capture[ 12 ] = 1; // analog.
+    LIN_CHECK( !source.Open( &capture[ 0 ], capture.size(), SampleRate ) );
+    capture[ 12 ] = 0;
+    capture[ 0 ] = 'X';
+    LIN_CHECK( !source.Open( &capture[ 0 ], capture.size(), SampleRate ) );
+}
+
+LIN_TEST( SampleBitsDecodeLikeEdgeList )
+{
+    LINWaveform waveform = Traffic();
+    std::vector<U8> capture = SampleBits( waveform.GetEdges(), waveform.GetSample() );
+    LINSampleBits source( &capture[ 0 ], capture.size() );
+    CheckSameFields( DecodeEdgeList( waveform ), Decode( source ) );
+}
+
+// edges on and either side of word and byte boundaries, runs longer than a word, and a last run that reaches the end.
+LIN_TEST( SampleBitsFindEveryEdge )
+{
+    const U64 edge_samples[] = { 1, 2, 7, 8, 63, 64, 65, 127, 128, 300, 301, 1000 };
+    std::vector<U64> edges( edge_samples, edge_samples + sizeof( edge_samples ) / sizeof( edge_samples[ 0 ] ) );
+    const U64 samples = 1030;
+    std::vector<U8> capture = SampleBits( edges, samples );
+
+    LINSampleBits bits( &capture[ 0 ], capture.size() );
+    LINEdgeList list( true, &edges[ 0 ], edges.size(), capture.size() * 8 - 1 );
+    for( size_t i = 0; i < edges.size(); i++ )
+    {
+        LIN_CHECK_EQUAL( list.GetSampleOfNextEdge(), bits.GetSampleOfNextEdge() );
+        LIN_CHECK_EQUAL( list.WouldAdvancingToAbsPositionCauseTransition( edges[ i ] - 1 ),
+                         bits.WouldAdvancingToAbsPositionCauseTransition( edges[ i ] - 1 ) );
+        LIN_CHECK( bits.WouldAdvancingToAbsPositionCauseTransition( edges[ i ] ) );
+        list.AdvanceToNextEdge();
+        bits.AdvanceToNextEdge();
+        LIN_CHECK_EQUAL( list.GetSampleNumber(), bits.GetSampleNumber() );
+        LIN_CHECK_EQUAL( list.IsHigh(), bits.IsHigh() );
+    }
+
+    bool ended = false;
+    try
+    {
+        bits.GetSampleOfNextEdge();
+    }
+    catch( LINEdgeStreamEnd& )
+    {
+        ended = true;
+    }
+    LIN_CHECK( ended );
+    LIN_CHECK( !bits.WouldAdvancingToAbsPositionCauseTransition( capture.size() * 8 ) );
+
+    // jumping into the middle of a run reads its level, and still finds the edge that ends it.
+    LINSampleBits jumping( &capture[ 0 ], capture.size() );
+    jumping.AdvanceToAbsPosition( 200 );
+    LIN_CHECK( !jumping.IsHigh() );
+    LIN_CHECK_EQUAL( 300, jumping.GetSampleOfNextEdge() );
+    jumping.AdvanceToAbsPosition( 500 );
+    LIN_CHECK( !jumping.IsHigh() );
+    LIN_CHECK_EQUAL( 1000, jumping.GetSampleOfNextEdge() );
+}
@@ -0,0 +1,91 @@
+#include "LINTest.h"
+#include "LINChecksum.h"
+#include "LINProtectedIdentifier.h"
+#include <stdlib.h>
+#include <vector>
+
+LIN_TEST( ChecksumSpecificationExample )
+{
+    // LIN 2.2A, section 2.8.3.
+    const U8 data[] = { 0x4A, 0x55, 0x93, 0xE5 };
+    LIN_CHECK_EQUAL( 0xE6, LINClassicChecksumEngine::Compute( 0x00, data, 4 ) );
+
+    LINChecksum checksum;
+    for( U32 i = 0; i < 4; i++ )
+        checksum.add( data[ i ] );
+    LIN_CHECK_EQUAL( 0xE6, checksum.result() );
+}
+
+LIN_TEST( ChecksumModels )
+{
+    const U8 data[] = { 0x01, 0x02 };
+    LIN_CHECK_EQUAL( U8( ~0x03 ), LINClassicChecksumEngine::Compute( 0x50, data, 2 ) );
+    LIN_CHECK_EQUAL( U8( ~0x53 ), LINEnhancedChecksumEngine::Compute( 0x50, data, 2 ) );
+
+    // the diagnostic frames keep the classic checksum under LIN 2.x.
+    LIN_CHECK_EQUAL( U8( ~0x03 ), LINEnhancedChecksumEngine::Compute( 0x3C, data, 2 ) );
+    LIN_CHECK_EQUAL( U8( ~0x03 ), LINEnhancedChecksumEngine::Compute( 0x7D, data, 2 ) );
+
+    LIN_CHECK( !LINChecksum::IsEnhanced( 1.3, 0x10 ) );
+    LIN_CHECK( LINChecksum::IsEnhanced( 2.0, 0x10 ) );
+    LIN_CHECK( !LINChecksum::IsEnhanced( 2.0, 0x3C ) );
+    LIN_CHECK( !LINChecksum::IsEnhanced( 2.0, 0x3D ) );
+}
+
+LIN_TEST( BatchVerifyMatchesRunningChecksum )
+{
+    const U32 count = 1000;
+    std::vector<U8> pids( count );
+    std::vector<U8> data( 8 * count, 0 );
+    std::vector<U8> checksums( count );
+    std::vector<U8> mismatches( count );
+    U32 expected_mismatches = 0;
+
+    srand( 1 );
+    for( U32 i = 0; i < count; i++ )
+    {
+        pids[ i ] = LINProtectedIdentifier( U8( rand() % 64 ) );
+        U32 length = 1 + rand() % 8;
+
+        LINChecksum checksum;
+        if( LINChecksum::IsEnhanced( 2.0, pids[ i ] & 0x3F ) )
+            checksum.add( pids[ i ] );
+        for( U32 j = 0; j < length; j++ )
+        {
+            data[ 8 * i + j ] = U8( rand() );
+            checksum.add( data[ 8 * i + j ] );
+        }
+
+        checksums[ i ] = checksum.result();
+        if( i % 7 == 0 )
+        {
+            checksums[ i ] ^= 0x40;
+            ++expected_mismatches;
+        }
+    }
+
+    U32 mismatch_count = LINEnhancedChecksumEngine::Verify( &pids[ 0 ], &data[ 0 ], &checksums[ 0 ], count, &mismatches[ 0 ] );
+    LIN_CHECK_EQUAL( expected_mismatches, mismatch_count );
+    for( U32 i = 0; i < count; i++ )
+        LIN_CHECK_EQUAL( i % 7 == 0, mismatches[ i ] );
+}
+
+LIN_TEST( ProtectedIdentifiers )
+{
+    U32 valid = 0;
+    for( U32 pid = 0; pid < 256; pid++ )
+    {
+        if( LINValidPIDs[ pid ] )
+            ++valid;
+    }
+    LIN_CHECK_EQUAL( 64, valid );
+
+    for( U32 identifier = 0; identifier < 64; identifier++ )
+    {
+        U8 pid = LINProtectedIdentifier( U8( identifier ) );
+        LIN_CHECK( LINValidPIDs[ pid ] );
+        LIN_CHECK( !LINValidPIDs[ pid ^ 0x40 ] );
+        LIN_CHECK( !LINValidPIDs[ pid ^ 0x80 ] );
+        LIN_CHECK( !LINValidPIDs[ pid ^ 0x01 ] );
+    }
+}
@@ -0,0 +1,131 @@
+#include "LINTest.h"
+#include "LINTestHarness.h"
+#include "LINDecoder.h"
+#include "LINProtectedIdentifier.h"
+#include <string.h>
+#include <vector>
+
+namespace
+{
+    const U32 SampleRate = 1000000;
+    const U32 BitRate = 19200;
+    const U8 Data[] = { 0x12, 0x34, 0x56, 0x78 };
+
+    // keeps everything the decoder reports.
+    class RecordingSink : public LINDecoderSink
+    {
+      public:
+        RecordingSink() : mMarkers( 0 ), mInterByteSpaces( 0 )
+        {
+        }
+
+        virtual void OnMarker( U64 /*sample*/, LINDecoder::tLINMarker /*marker*/ )
+        {
+            ++mMarkers;
+        }
+
+        virtual void OnInterByteSpace( S64 /*starting_sample*/, S64 /*ending_sample*/ )
+        {
+            ++mInterByteSpaces;
+        }
+
+        virtual void OnField( const LINDecoder::Field& field )
+        {
+            mFields.push_back( field );
+        }
+
+        virtual void OnLINFrame( const LINDecoder::LINFrame& lin_frame )
+        {
+            mLINFrames.push_back( lin_frame );
+        }
+
+        U32 mMarkers;
+        U32 mInterByteSpaces;
+        std::vector<LINDecoder::Field> mFields;
+        std::vector<LINDecoder::LINFrame> mLINFrames;
+    };
+
+    void Decode( const LINWaveform& waveform, RecordingSink& sink )
+    {
+        const std::vector<U64>& edges = waveform.GetEdges();
+        LINEdgeList source( true, edges.empty() ? NULL : &edges[ 0 ], edges.size(), waveform.GetSample() );
+
+        LINDecoder::Settings settings;
+        settings.mSampleRate = SampleRate;
+        settings.mBitRate = BitRate;
+
+        LINDecoder decoder;
+        decoder.Run( &source, &sink, settings );
+    }
+}
+
+// the decoder on its own reads the same fields as the analyzer, and assembles the LIN frames.
+LIN_TEST( DecoderWithoutAnalyzer )
+{
+    LINWaveform waveform( SampleRate, BitRate );
+    waveform.Idle( 20 );
+    waveform.Frame( 0x10, Data, 4, true );
+    waveform.Idle( 10 );
+    waveform.Frame( 0x11, Data, 2, true, true );
+    waveform.Idle( 20 );
+
+    RecordingSink sink;
+    Decode( waveform, sink );
+
+    LINTestAnalyzer analyzer( SampleRate, BitRate );
+    analyzer.Run( waveform );
+    std::vector<Frame> frames = analyzer.ByteFrames();
+
+    LIN_CHECK_EQUAL( frames.size(), sink.mFields.size() );
+    for( size_t i = 0; i < frames.size() && i < sink.mFields.size(); i++ )
+    {
+        LIN_CHECK_EQUAL( frames[ i ].mStartingSampleInclusive, sink.mFields[ i ].mStartingSample );
+        LIN_CHECK_EQUAL( frames[ i ].mEndingSampleInclusive, sink.mFields[ i ].mEndingSample );
+        LIN_CHECK_EQUAL( frames[ i ].mType, sink.mFields[ i ].mType );
+        LIN_CHECK_EQUAL( frames[ i ].mData1, sink.mFields[ i ].mData );
+        LIN_CHECK_EQUAL( frames[ i ].mData2, sink.mFields[ i ].mDataBytes );
+        LIN_CHECK_EQUAL( frames[ i ].mFlags, sink.mFields[ i ].mFlags );
+    }
+    LIN_CHECK_EQUAL( analyzer.Results().GetNumFrames() - frames.size(), sink.mInterByteSpaces );
+    LIN_CHECK_EQUAL( analyzer.Results().mMarkers.size(), sink.mMarkers );
+
+    LIN_CHECK_EQUAL( 2, sink.mLINFrames.size() );
+    if( sink.mLINFrames.size() != 2 )
+        return;
+
+    const LINDecoder::LINFrame& first = sink.mLINFrames[ 0 ];
+    LIN_CHECK( first.mHasPID && first.mEnhancedChecksum );
+    LIN_CHECK_EQUAL( LINProtectedIdentifier( 0x10 ), first.mPID );
+    LIN_CHECK_EQUAL( 5, first.mResponseLength );
+    LIN_CHECK_EQUAL( 0, memcmp( first.mResponse, Data, 4 ) );
+    LIN_CHECK_EQUAL( 0, first.mFlags );
+    LIN_CHECK_EQUAL( sink.mFields[ 0 ].mStartingSample, first.mStartingSample );
+    LIN_CHECK_EQUAL( sink.mFields[ 7 ].mEndingSample, first.mEndingSample );
+
+    const LINDecoder::LINFrame& second = sink.mLINFrames[ 1 ];
+    LIN_CHECK_EQUAL( LINProtectedIdentifier( 0x11 ), second.mPID );
+    LIN_CHECK_EQUAL( 3, second.mResponseLength );
+    LIN_CHECK_EQUAL( LINDecoder::checksumMismatch, second.mFlags );
+}
+
+// a frame cut off by the end of the edges is still reported.
+LIN_TEST( DecoderFlushesAtEndOfEdges )
+{
+    LINWaveform waveform( SampleRate, BitRate );
+    waveform.Idle( 20 );
+    waveform.Break();
+    waveform.Byte( 0x55 );
+    waveform.Byte( LINProtectedIdentifier( 0x20 ) );
+    waveform.Idle( 20 );
+
+    RecordingSink sink;
+    Decode( waveform, sink );
+
+    LIN_CHECK_EQUAL( 3, sink.mFields.size() );
+    LIN_CHECK_EQUAL( 1, sink.mLINFrames.size() );
+    if( sink.mLINFrames.empty() )
+        return;
+    LIN_CHECK( sink.mLINFrames[ 0 ].mHasPID );
+    LIN_CHECK_EQUAL( LINProtectedIdentifier( 0x20 ), sink.mLINFrames[ 0 ].mPID );
+    LIN_CHECK_EQUAL( 0, sink.mLINFrames[ 0 ].mResponseLength );
+}
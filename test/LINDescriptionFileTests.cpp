@@ -0,0 +1,103 @@
+#include "LINTest.h"
+#include "LINDescriptionFile.h"
+#include <string.h>
+
+namespace
+{
+    const char* const Cluster = "/* sample */\n"
+                                "LIN_description_file;\n"
+                                "LIN_protocol_version = \"2.1\";\n"
+                                "LIN_language_version = \"2.1\";\n"
+                                "LIN_speed = 19.2 kbps;\n"
+                                "Nodes {\n"
+                                "  Master: CEM, 5 ms, 0.1 ms;\n"
+                                "  Slaves: LSM, RSM;\n"
+                                "}\n"
+                                "Signals {\n"
+                                "  InternalLightsRequest: 2, 0, CEM, LSM, RSM;\n"
+                                "}\n"
+                                "Frames {\n"
+                                "  CEM_Frm1: 0x01, CEM, 1 {\n"
+                                "    InternalLightsRequest, 0;\n"
+                                "  }\n"
+                                "  LSM_Frm1: 0x02, LSM, 2 {\n"
+                                "    LeftSwitch, 8;\n"
+                                "  }\n"
+                                "  RSM_Frm1: 0x03, RSM, 4 { RightSwitch, 8; } // trailing comment\n"
+                                "}\n"
+                                "Diagnostic_frames {\n"
+                                "  MasterReq: 0x3c { MasterReqB0, 0; }\n"
+                                "  SlaveResp: 0x3d { SlaveRespB0, 0; }\n"
+                                "}\n"
+                                "Node_attributes {\n"
+                                "  LSM { LIN_protocol = \"1.3\"; configured_NAD = 0x20; }\n"
+                                "  RSM { LIN_protocol = \"2.1\"; }\n"
+                                "}\n";
+
+    bool PublishedBy( const LINDescriptionFile& description, U8 identifier, const char* node )
+    {
+        const LINDescriptionFile::FrameInfo* frame = description.GetFrame( identifier );
+        const char* name = frame != NULL ? description.GetNodeName( frame->mPublisher ) : NULL;
+        return node == NULL ? name == NULL : name != NULL && strcmp( name, node ) == 0;
+    }
+}
+
+LIN_TEST( DescriptionFileFrames )
+{
+    LINDescriptionFile description;
+    LIN_CHECK( description.Parse( Cluster ) );
+    LIN_CHECK( !description.IsEmpty() );
+
+    const U8 identifiers[] = { 0x01, 0x02, 0x03, 0x3C, 0x3D };
+    const U8 lengths[] = { 1, 2, 4, 8, 8 };
+    const bool enhanced[] = { true, false, true, false, false };
+    for( U32 i = 0; i < 5; i++ )
+    {
+        const LINDescriptionFile::FrameInfo* frame = description.GetFrame( identifiers[ i ] );
+        LIN_CHECK( frame != NULL );
+        if( frame == NULL )
+            continue;
+        LIN_CHECK_EQUAL( lengths[ i ], frame->mLength );
+        LIN_CHECK_EQUAL( enhanced[ i ], frame->mEnhancedChecksum );
+    }
+
+    LIN_CHECK( PublishedBy( description, 0x01, "CEM" ) );
+    LIN_CHECK( PublishedBy( description, 0x02, "LSM" ) );
+    LIN_CHECK( PublishedBy( description, 0x03, "RSM" ) );
+    LIN_CHECK( PublishedBy( description, 0x3C, "CEM" ) );
+    LIN_CHECK( PublishedBy( description, 0x3D, NULL ) );
+    LIN_CHECK( description.GetFrame( 0x04 ) == NULL );
+}
+
+LIN_TEST( DescriptionFileRejectsBadInput )
+{
+    LINDescriptionFile description;
+    LIN_CHECK( !description.Parse( "" ) );
+    LIN_CHECK( !description.Parse( "LIN_description_file; Frames { F: 0x40, M, 2 { } }" ) );
+    LIN_CHECK( !description.Parse( "LIN_description_file; Frames { F: 0x01, M, 9 { } }" ) );
+    LIN_CHECK( !description.Parse( "LIN_description_file; Frames { F: 0x01, M, 2 { }" ) );
+    LIN_CHECK( !description.Parse( "LIN_description_file; /* unterminated" ) );
+    // frames cut short anywhere, including right before the closing brace of the last section.
+    LIN_CHECK( !description.Parse( "LIN_description_file ; Frames { F : 1 , }" ) );
+    LIN_CHECK( !description.Parse( "LIN_description_file ; Frames { F : 1 , M , }" ) );
+    LIN_CHECK( !description.Parse( "LIN_description_file ; Frames { F : 1 , M , 2 }" ) );
+    LIN_CHECK( !description.Parse( "LIN_description_file ; Frames { F : 1 , M }" ) );
+    LIN_CHECK( !description.Parse( "LIN_description_file ; Frames { F : }" ) );
+    LIN_CHECK( !description.Parse( "LIN_description_file ; Frames { F }" ) );
+    LIN_CHECK( !description.Parse( "LIN_description_file ; Frames { F : 1 , M , 2 { } G : 2 , }" ) );
+    LIN_CHECK( !description.Parse( "LIN_description_file ; Nodes { Master }" ) );
+    LIN_CHECK( !description.Parse( "LIN_description_file ; Node_attributes { LSM }" ) );
+    LIN_CHECK( !description.Parse( "LIN_description_file ; LIN_protocol_version =" ) );
+
+    // every prefix of a valid file is either rejected or read without running past its end.
+    const std::string cluster( Cluster );
+    for( size_t length = 0; length < cluster.size(); length++ )
+        description.Parse( cluster.substr( 0, length ) );
+
+    const char embedded_nul[] = "LIN_description_file; Frames { F\0: 0x01 }";
+    LIN_CHECK( !description.Parse( std::string( embedded_nul, sizeof( embedded_nul ) - 1 ) ) );
+    LIN_CHECK( description.IsEmpty() );
+
+    LIN_CHECK( !description.Load( "no_such_file.ldf" ) );
+    LIN_CHECK( description.IsEmpty() );
+}
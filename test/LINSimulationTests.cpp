@@ -0,0 +1,228 @@
+#include "LINTest.h"
+#include "LINTestHarness.h"
+#include "LINProtectedIdentifier.h"
+#include <stdio.h>
+#include <string.h>
+
+namespace
+{
+    const U32 SampleRate = 1000000;
+    const U32 BitRate = 19200;
+    const U64 Samples = 500000; // about 100 frames.
+
+    const char* const ScheduleFileText = "LIN_description_file;\n"
+                                         "LIN_protocol_version = \"2.1\";\n"
+                                         "Nodes { Master: CEM, 5 ms, 0.1 ms; Slaves: LSM; }\n"
+                                         "Frames {\n"
+                                         "  CEM_Frm1: 0x01, CEM, 1 { }\n"
+                                         "  LSM_Frm1: 0x02, LSM, 2 { }\n"
+                                         "  CEM_Frm2: 0x20, CEM, 8 { }\n"
+                                         "}\n";
+
+    const char* WriteScheduleFile()
+    {
+        const char* path = "lin_simulation_tests.ldf";
+        FILE* file = fopen( path, "wb" );
+        LIN_CHECK( file != NULL );
+        if( file == NULL )
+            return NULL;
+        fwrite( ScheduleFileText, 1, strlen( ScheduleFileText ), file );
+        fclose( file );
+        return path;
+    }
+
+    // the byte frames decoded from the schedule of ScheduleFileText, simulated with the given settings.
+    std::vector<Frame> SimulateSchedule( U64 samples, U32 bus_load = 100, U32 error_rate = 0,
+                                         LINAnalyzerSettings::tLINSimulationImpairments impairments = LINAnalyzerSettings::ImpairNone )
+    {
+        const char* path = WriteScheduleFile();
+        LINTestAnalyzer analyzer( SampleRate, BitRate );
+        analyzer.Settings().mDescriptionFile = path != NULL ? path : "";
+        analyzer.Settings().mSimulationTraffic = LINAnalyzerSettings::SimulateSchedule;
+        analyzer.Settings().mSimulationBusLoad = bus_load;
+        analyzer.Settings().mSimulationErrorRate = error_rate;
+        analyzer.Settings().mSimulationImpairments = impairments;
+        analyzer.LoadSimulation( samples );
+        analyzer.RunToCompletion();
+        remove( path );
+        return analyzer.ByteFrames();
+    }
+
+    std::vector<U64> Simulate( U32 seed )
+    {
+        LINTestAnalyzer analyzer( SampleRate, BitRate );
+        analyzer.Settings().mSimulationSeed = seed;
+        analyzer.Settings().mSimulationErrorRate = 100;
+        SimulationChannelDescriptor* channel;
+        analyzer.GenerateSimulationData( Samples, SampleRate, &channel );
+        return channel->mEdges;
+    }
+
+    U32 CountFlags( const std::vector<Frame>& frames, U8 flag )
+    {
+        U32 count = 0;
+        for( size_t i = 0; i < frames.size(); i++ )
+        {
+            if( ( frames[ i ].mFlags & flag ) != 0 )
+                ++count;
+        }
+        return count;
+    }
+
+    // the PIDs of the schedule file that are out of turn.
+    U32 CountOutOfTurn( const std::vector<U8>& pids )
+    {
+        const U8 schedule[] = { LINProtectedIdentifier( 0x01 ), LINProtectedIdentifier( 0x02 ), LINProtectedIdentifier( 0x20 ) };
+        U32 count = 0;
+        for( size_t i = 1; i < pids.size(); i++ )
+        {
+            U32 next = pids[ i - 1 ] == schedule[ 0 ] ? 1 : ( pids[ i - 1 ] == schedule[ 1 ] ? 2 : 0 );
+            if( pids[ i ] != schedule[ next ] )
+                ++count;
+        }
+        return count;
+    }
+
+    std::vector<U8> DecodedPIDs( const std::vector<Frame>& frames )
+    {
+        std::vector<U8> pids;
+        for( size_t i = 0; i < frames.size(); i++ )
+        {
+            if( frames[ i ].mType == LINDecoder::headerPID )
+                pids.push_back( U8( frames[ i ].mData1 ) );
+        }
+        return pids;
+    }
+}
+
+LIN_TEST( SimulationIsReproducible )
+{
+    std::vector<U64> first = Simulate( 7 );
+    LIN_CHECK( first.size() > 1000 );
+    LIN_CHECK( first == Simulate( 7 ) );
+    LIN_CHECK( first != Simulate( 8 ) );
+}
+
+LIN_TEST( SimulationScheduleTable )
+{
+    // the frames of the LDF, in identifier order, over and over; the decoder knows their lengths from the same file.
+    std::vector<Frame> frames = SimulateSchedule( Samples );
+    std::vector<U8> pids = DecodedPIDs( frames );
+    const U8 schedule[] = { LINProtectedIdentifier( 0x01 ), LINProtectedIdentifier( 0x02 ), LINProtectedIdentifier( 0x20 ) };
+    const U32 lengths[] = { 1, 2, 8 };
+    LIN_CHECK( pids.size() > 30 );
+    size_t expected_frames = 0;
+    for( size_t i = 0; i < pids.size(); i++ )
+    {
+        LIN_CHECK_EQUAL( schedule[ i % 3 ], pids[ i ] );
+        expected_frames += 4 + lengths[ i % 3 ];
+    }
+    LIN_CHECK_EQUAL( expected_frames, frames.size() );
+    LIN_CHECK_EQUAL( 0, CountFlags( frames, 0xFF ) );
+}
+
+LIN_TEST( SimulationBusLoad )
+{
+    U64 headers[ 2 ];
+    for( U32 i = 0; i < 2; i++ )
+        headers[ i ] = DecodedPIDs( SimulateSchedule( Samples, i == 0 ? 100 : 25 ) ).size();
+
+    // a quarter of the load fits about a quarter of the frames into the same capture.
+    LIN_CHECK( headers[ 0 ] > 50 );
+    LIN_CHECK( headers[ 1 ] * 4 > headers[ 0 ] * 9 / 10 && headers[ 1 ] * 4 < headers[ 0 ] * 11 / 10 );
+}
+
+LIN_TEST( SimulationInjectsErrors )
+{
+    std::vector<Frame> frames = SimulateSchedule( Samples, 100, 1000 );
+    LIN_CHECK( CountFlags( frames, LINDecoder::checksumMismatch ) > 5 );
+    LIN_CHECK( CountFlags( frames, LINDecoder::pidParityError ) > 5 );
+    LIN_CHECK( CountFlags( frames, LINDecoder::byteFramingError ) > 5 );
+}
+
+LIN_TEST( SimulationMildImpairments )
+{
+    // a healthy bus: no frame is lost, and only the odd glitch is flagged.
+    std::vector<Frame> frames = SimulateSchedule( Samples * 4, 100, 0, LINAnalyzerSettings::ImpairMild );
+    std::vector<U8> pids = DecodedPIDs( frames );
+    LIN_CHECK( pids.size() > 300 );
+    LIN_CHECK_EQUAL( LINProtectedIdentifier( 0x01 ), pids.empty() ? 0 : pids[ 0 ] );
+    LIN_CHECK_EQUAL( 0, CountOutOfTurn( pids ) );
+    LIN_CHECK( CountFlags( frames, 0xFF ) < frames.size() / 100 );
+}
+
+LIN_TEST( SimulationHarshImpairments )
+{
+    LINTestAnalyzer ideal( SampleRate, BitRate );
+    SimulationChannelDescriptor* ideal_channel;
+    ideal.GenerateSimulationData( Samples, SampleRate, &ideal_channel );
+
+    LINTestAnalyzer analyzer( SampleRate, BitRate );
+    analyzer.Settings().mSimulationImpairments = LINAnalyzerSettings::ImpairHarsh;
+    SimulationChannelDescriptor* channel;
+    analyzer.GenerateSimulationData( Samples, SampleRate, &channel );
+    LIN_CHECK( channel->mEdges != ideal_channel->mEdges );
+
+    // the decoder flags what it can't read, and keeps finding breaks to the end of the capture.
+    analyzer.LoadSimulation( Samples );
+    analyzer.RunToCompletion();
+    std::vector<Frame> frames = analyzer.ByteFrames();
+    LIN_CHECK( CountFlags( frames, 0xFF ) > 10 );
+    LIN_CHECK( analyzer.Results().GetNumPackets() > 20 );
+    LIN_CHECK( !frames.empty() && frames.back().mEndingSampleInclusive > S64( Samples * 9 / 10 ) );
+}
+
+LIN_TEST( SimulationReplaysTrace )
+{
+    // a clean frame, one with a wrong checksum, and a header with bad parity and no response. The simulator sends every byte
+    // with two bits of space and two stop bits, so the frames are spaced out enough for it to keep to the recorded times.
+    const U8 data[] = { 0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0xDE, 0xF0 };
+    LINWaveform waveform( SampleRate, BitRate );
+    waveform.Idle( 20 );
+    waveform.Frame( 0x10, data, 4, true );
+    waveform.Idle( 60 );
+    waveform.Frame( 0x11, data, 8, true, true );
+    waveform.Idle( 60 );
+    waveform.Break();
+    waveform.Byte( 0x55 );
+    waveform.Byte( LINProtectedIdentifier( 0x12 ) ^ 0x80 );
+    waveform.Idle( 60 );
+    waveform.Frame( 0x13, data, 2, false );
+    waveform.Idle( 60 );
+    waveform.Break(); // a packet is only exported once the next one starts.
+    waveform.Byte( 0x55 );
+    waveform.Idle( 20 );
+
+    LINTestAnalyzer recorded( SampleRate, BitRate );
+    recorded.Run( waveform );
+    const char* path = "lin_simulation_tests.linbin";
+    recorded.Results().GenerateExportFile( path, Hexadecimal, LINAnalyzerSettings::BinaryExport );
+
+    // replayed at the recorded sample rate, and at twice it; the decoder sees the same bytes at the same times.
+    for( U32 scale = 1; scale <= 2; scale++ )
+    {
+        LINTestAnalyzer replayed( SampleRate * scale, BitRate );
+        replayed.Settings().mSimulationTraffic = LINAnalyzerSettings::SimulateReplay;
+        replayed.Settings().mSimulationTraceFile = path;
+        replayed.LoadSimulation( waveform.GetSample() * scale );
+        replayed.RunToCompletion();
+
+        std::vector<Frame> expected = recorded.ByteFrames();
+        expected.resize( expected.size() - 2 );
+        std::vector<Frame> frames = replayed.ByteFrames();
+        LIN_CHECK_EQUAL( expected.size(), frames.size() );
+        for( size_t i = 0; i < expected.size() && i < frames.size(); i++ )
+        {
+            LIN_CHECK_EQUAL( expected[ i ].mType, frames[ i ].mType );
+            LIN_CHECK_EQUAL( expected[ i ].mData1, frames[ i ].mData1 );
+            LIN_CHECK_EQUAL( expected[ i ].mFlags, frames[ i ].mFlags );
+
+            // the breaks start where they were recorded, give or take a sample at either rate.
+            const S64 recorded_start = expected[ i ].mStartingSampleInclusive * S64( scale );
+            if( expected[ i ].mType == LINDecoder::headerBreak )
+                LIN_CHECK( frames[ i ].mStartingSampleInclusive - recorded_start < 2 * S64( scale ) &&
+                           recorded_start - frames[ i ].mStartingSampleInclusive < 2 * S64( scale ) );
+        }
+    }
+    remove( path );
+}
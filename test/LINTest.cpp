@@ -0,0 +1,65 @@
+#include "LINTest.h"
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+    struct RegisteredTest
+    {
+        const char* mName;
+        LINTestFunction mFunction;
+    };
+
+    std::vector<RegisteredTest>& Tests()
+    {
+        static std::vector<RegisteredTest> tests;
+        return tests;
+    }
+
+    U32 gFailures = 0;
+}
+
+LINTestRegistration::LINTestRegistration( const char* name, LINTestFunction function )
+{
+    RegisteredTest test = { name, function };
+    Tests().push_back( test );
+}
+
+void LINTestFailure( const char* file, int line, const char* expression )
+{
+    printf( "%s:%d: check failed: %s\n", file, line, expression );
+    ++gFailures;
+}
+
+void LINTestFailureEqual( const char* file, int line, const char* expression, S64 expected, S64 actual )
+{
+    printf( "%s:%d: check failed: %s (expected %lld, got %lld)\n", file, line, expression, expected, actual );
+    ++gFailures;
+}
+
+// runs every test, or only those whose names contain the first argument.
+int main( int argc, char** argv )
+{
+    const char* filter = argc > 1 ? argv[ 1 ] : "";
+    U32 run = 0;
+    U32 failed = 0;
+    for( size_t i = 0; i < Tests().size(); i++ )
+    {
+        const RegisteredTest& test = Tests()[ i ];
+        if( strstr( test.mName, filter ) == NULL )
+            continue;
+
+        U32 failures_before = gFailures;
+        test.mFunction();
+        ++run;
+        if( gFailures != failures_before )
+        {
+            printf( "FAILED %s\n", test.mName );
+            ++failed;
+        }
+    }
+
+    printf( "%u tests, %u failed\n", run, failed );
+    return failed == 0 && run != 0 ? 0 : 1;
+}
@@ -0,0 +1,38 @@
+#ifndef LIN_TEST_H
+#define LIN_TEST_H
+
+#include <LogicPublicTypes.h>
+
+// a minimal test runner, so the tests need nothing beyond the mock SDK. A failed check is reported and the test carries on.
+typedef void ( *LINTestFunction )();
+
+struct LINTestRegistration
+{
+    LINTestRegistration( const char* name, LINTestFunction function );
+};
+
+void LINTestFailure( const char* file, int line, const char* expression );
+void LINTestFailureEqual( const char* file, int line, const char* expression, S64 expected, S64 actual );
+
+#define LIN_TEST( name )                                                   \
+    static void name();                                                    \
+    static LINTestRegistration name##Registration( #name, name );          \
+    static void name()
+
+#define LIN_CHECK( expression )                                            \
+    do                                                                     \
+    {                                                                      \
+        if( !( expression ) )                                              \
+            LINTestFailure( __FILE__, __LINE__, #expression );             \
+    } while( 0 )
+
+#define LIN_CHECK_EQUAL( expected, actual )                                                          \
+    do                                                                                               \
+    {                                                                                                \
+        S64 lin_expected = S64( expected );                                                          \
+        S64 lin_actual = S64( actual );                                                              \
+        if( lin_expected != lin_actual )                                                             \
+            LINTestFailureEqual( __FILE__, __LINE__, #expected " == " #actual, lin_expected, lin_actual ); \
+    } while( 0 )
+
+#endif // LIN_TEST_H
@@ -0,0 +1,128 @@
+#include "LINTestHarness.h"
+#include "LINProtectedIdentifier.h"
+
+LINWaveform::LINWaveform( U32 sample_rate, U32 bit_rate ) : mSampleRate( sample_rate ), mBitRate( bit_rate ), mBits( 0 ), mState( BIT_HIGH )
+{
+}
+
+void LINWaveform::Level( BitState state, double bits )
+{
+    if( state != mState )
+    {
+        mEdges.push_back( GetSample() );
+        mState = state;
+    }
+    mBits += bits;
+}
+
+void LINWaveform::Idle( double bits )
+{
+    Level( BIT_HIGH, bits );
+}
+
+void LINWaveform::Break( U32 low_bits, double delimiter_bits )
+{
+    Level( BIT_LOW, low_bits );
+    Level( BIT_HIGH, delimiter_bits );
+}
+
+void LINWaveform::Byte( U8 value, bool stop_bit, double space_bits )
+{
+    Idle( space_bits );
+    Level( BIT_LOW, 1 );
+    for( U32 i = 0; i < 8; i++ )
+        Level( ( value >> i ) & 1 ? BIT_HIGH : BIT_LOW, 1 );
+    Level( stop_bit ? BIT_HIGH : BIT_LOW, 1 );
+    if( !stop_bit )
+        Level( BIT_HIGH, 0 );
+}
+
+void LINWaveform::Frame( U8 identifier, const U8* data, U32 length, bool enhanced, bool checksum_error )
+{
+    const U8 pid = LINProtectedIdentifier( identifier );
+    Break();
+    Byte( 0x55 );
+    Byte( pid );
+
+    U8 checksum = enhanced ? LINEnhancedChecksumEngine::Compute( pid, data, length )
+                           : LINClassicChecksumEngine::Compute( pid, data, length );
+    for( U32 i = 0; i < length; i++ )
+        Byte( data[ i ] );
+    Byte( checksum_error ? U8( checksum ^ 0x01 ) : checksum );
+}
+
+U64 LINWaveform::GetSample() const
+{
+    return U64( mBits * mSampleRate / mBitRate + 0.5 );
+}
+
+const std::vector<U64>& LINWaveform::GetEdges() const
+{
+    return mEdges;
+}
+
+LINTestAnalyzer::LINTestAnalyzer( U32 sample_rate, U32 bit_rate )
+{
+    mSettings->mInputChannel = Channel( 0, 0, DIGITAL_CHANNEL );
+    mSettings->mBitRate = bit_rate;
+    SetSampleRate( sample_rate );
+    SetSimulationSampleRate( sample_rate );
+}
+
+LINAnalyzerSettings& LINTestAnalyzer::Settings()
+{
+    return *mSettings;
+}
+
+LINAnalyzerResults& LINTestAnalyzer::Results()
+{
+    return *mResults;
+}
+
+void LINTestAnalyzer::Load( const LINWaveform& waveform )
+{
+    // a run ends when the decoder asks for data past the end of the capture.
+    mChannelData.reset( new AnalyzerChannelData( BIT_HIGH, waveform.GetEdges(), waveform.GetSample() ) );
+    SetChannelData( mSettings->mInputChannel, mChannelData.get() );
+    if( mResults.get() == NULL )
+        SetupResults();
+}
+
+void LINTestAnalyzer::Run( const LINWaveform& waveform )
+{
+    Load( waveform );
+    RunToCompletion();
+}
+
+void LINTestAnalyzer::LoadSimulation( U64 samples )
+{
+    SimulationChannelDescriptor* channel;
+    GenerateSimulationData( samples, GetSimulationSampleRate(), &channel );
+    mChannelData.reset( new AnalyzerChannelData( BIT_HIGH, channel->mEdges, channel->GetCurrentSampleNumber() ) );
+    SetChannelData( mSettings->mInputChannel, mChannelData.get() );
+    if( mResults.get() == NULL )
+        SetupResults();
+}
+
+std::vector<Frame> LINTestAnalyzer::ByteFrames()
+{
+    std::vector<Frame> frames;
+    for( U64 i = 0; i < mResults->GetNumFrames(); i++ )
+    {
+        Frame frame = mResults->GetFrame( i );
+        if( frame.mType != LINDecoder::NoFrame || frame.mFlags != 0 )
+            frames.push_back( frame );
+    }
+    return frames;
+}
+
+U32 LINTestAnalyzer::CountMarkers( AnalyzerResults::MarkerType type )
+{
+    U32 count = 0;
+    for( size_t i = 0; i < mResults->mMarkers.size(); i++ )
+    {
+        if( mResults->mMarkers[ i ].mType == type )
+            ++count;
+    }
+    return count;
+}
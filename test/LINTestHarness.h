@@ -0,0 +1,62 @@
+#ifndef LIN_TEST_HARNESS_H
+#define LIN_TEST_HARNESS_H
+
+#include <AnalyzerChannelData.h>
+#include <memory>
+#include <vector>
+
+#include "LINAnalyzer.h"
+#include "LINAnalyzerSettings.h"
+
+// builds a LIN bus waveform as a list of edges. Bit boundaries are rounded from an exact bit time, so rates that don't
+// divide the sample rate jitter the way a real capture does.
+class LINWaveform
+{
+  public:
+    LINWaveform( U32 sample_rate, U32 bit_rate );
+
+    void Level( BitState state, double bits );
+    void Idle( double bits );
+    void Break( U32 low_bits = 13, double delimiter_bits = 1 );
+    void Byte( U8 value, bool stop_bit = true, double space_bits = 0 );
+
+    // a whole frame: break, sync, PID with its parity bits, data and checksum. The checksum model follows `enhanced`; pass
+    // `checksum_error` to send a wrong one.
+    void Frame( U8 identifier, const U8* data, U32 length, bool enhanced, bool checksum_error = false );
+
+    U64 GetSample() const;
+    const std::vector<U64>& GetEdges() const;
+
+  protected:
+    U32 mSampleRate;
+    U32 mBitRate;
+    double mBits; // position, in bits from the start of the capture.
+    BitState mState;
+    std::vector<U64> mEdges;
+};
+
+// LINAnalyzer run over a LINWaveform on the mock SDK, with its settings and results exposed.
+class LINTestAnalyzer : public LINAnalyzer
+{
+  public:
+    LINTestAnalyzer( U32 sample_rate, U32 bit_rate );
+
+    LINAnalyzerSettings& Settings();
+    LINAnalyzerResults& Results();
+
+    // Load() hands the waveform to the analyzer and sets up the results; Run() also decodes it.
+    void Load( const LINWaveform& waveform );
+    void Run( const LINWaveform& waveform );
+
+    // loads `samples` of the analyzer's own simulation data instead, as set up by Settings().
+    void LoadSimulation( U64 samples );
+
+    // the decoded bytes and breaks, without the inter-byte space frames.
+    std::vector<Frame> ByteFrames();
+    U32 CountMarkers( AnalyzerResults::MarkerType type );
+
+  protected:
+    std::auto_ptr<AnalyzerChannelData> mChannelData;
+};
+
+#endif // LIN_TEST_HARNESS_H
@@ -0,0 +1,65 @@
+#ifndef ANALYZER_H
+#define ANALYZER_H
+
+#include "LogicPublicTypes.h"
+#include "AnalyzerTypes.h"
+#include "AnalyzerSettings.h"
+#include "AnalyzerResults.h"
+#include "AnalyzerChannelData.h"
+#include "SimulationChannelDescriptor.h"
+#include <map>
+
+class LOGICAPI Analyzer
+{
+  public:
+    Analyzer();
+    virtual ~Analyzer();
+    virtual void WorkerThread() = 0;
+
+    // sample_rate: if there are multiple devices attached, and one is faster than the other,
+    // we can sample at the speed of the faster one; and pretend the slower one is the same speed.
+    virtual U32 GenerateSimulationData( U64 newest_sample_requested, U32 sample_rate,
+                                        SimulationChannelDescriptor** simulation_channels ) = 0;
+    virtual U32 GetMinimumSampleRateHz() = 0; // provide the sample rate required to generate good simulation data
+    virtual const char* GetAnalyzerName() const = 0;
+    virtual bool NeedsRerun() = 0;
+
+    // use, but don't override:
+    void SetAnalyzerSettings( AnalyzerSettings* settings );
+    void KillThread();
+    AnalyzerChannelData* GetAnalyzerChannelData( Channel& channel ); // caller does not own memory.
+    void ReportProgress( U64 sample_number );
+    void SetAnalyzerResults( AnalyzerResults* results );
+    U32 GetSimulationSampleRate();
+    U32 GetSampleRate();
+    U64 GetTriggerSample();
+    void CheckIfThreadShouldExit();
+    void UseFrameV2();
+
+    // Stand-in only: wire up a capture and run the worker to the end of it.
+    void SetChannelData( const Channel& channel, AnalyzerChannelData* data );
+    void SetSampleRate( U32 sample_rate_hz );
+    void SetSimulationSampleRate( U32 sample_rate_hz );
+    void SetTriggerSample( U64 trigger_sample );
+    void RunToCompletion();
+
+    U64 mLastProgressSample;
+    U64 mProgressReports;
+
+  protected:
+    AnalyzerSettings* mAnalyzerSettings;
+    AnalyzerResults* mAnalyzerResults;
+    std::map<Channel, AnalyzerChannelData*> mChannelData;
+    U32 mSampleRateHz;
+    U32 mSimulationSampleRateHz;
+    U64 mTriggerSample;
+};
+
+class LOGICAPI Analyzer2 : public Analyzer
+{
+  public:
+    Analyzer2();
+    virtual void SetupResults();
+};
+
+#endif // ANALYZER_H
@@ -0,0 +1,56 @@
+#ifndef ANALYZER_CHANNEL_DATA
+#define ANALYZER_CHANNEL_DATA
+
+#include "LogicPublicTypes.h"
+#include <stddef.h>
+#include <vector>
+
+// Thrown when the decoder asks for data past the end of the in-memory capture. The real SDK blocks
+// (or unwinds the worker thread) in this situation; the harness catches this to end a run.
+struct AnalyzerChannelDataExhausted
+{
+};
+
+// In-memory edge stream. `edges` holds the sample numbers at which the line toggles, in ascending order.
+class LOGICAPI AnalyzerChannelData
+{
+  public:
+    AnalyzerChannelData( BitState initial_state, const std::vector<U64>& edges, U64 end_sample );
+    ~AnalyzerChannelData();
+
+    // State
+    U64 GetSampleNumber();
+    BitState GetBitState();
+
+    // Basic:
+    U32 Advance( U32 num_samples );
+    U32 AdvanceToAbsPosition( U64 sample_number );
+    void AdvanceToNextEdge();
+
+    // Fancier
+    U64 GetSampleOfNextEdge();
+    bool WouldAdvancingCauseTransition( U32 num_samples );
+    bool WouldAdvancingToAbsPositionCauseTransition( U64 sample_number );
+
+    // Minimum pulse tracking
+    void TrackMinimumPulseWidth();
+    U64 GetMinimumPulseWidthSoFar();
+
+    bool DoMoreTransitionsExistInCurrentData();
+
+    // Stand-in only: SDK calls made on this channel, for throughput accounting.
+    U64 GetCallCount() const;
+
+  protected:
+    void MoveTo( U64 sample_number );
+
+    std::vector<U64> mEdges;
+    U64 mEndSample;
+    U64 mSampleNumber;
+    size_t mNextEdgeIndex;
+    BitState mInitialState;
+    BitState mBitState;
+    U64 mCallCount;
+};
+
+#endif // ANALYZER_CHANNEL_DATA
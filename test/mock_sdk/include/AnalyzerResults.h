@@ -0,0 +1,162 @@
+#ifndef ANALYZERRESULTS
+#define ANALYZERRESULTS
+
+#include "LogicPublicTypes.h"
+#include "AnalyzerTypes.h"
+#include <string>
+#include <vector>
+
+#define DISPLAY_AS_ERROR_FLAG ( 1 << 7 )
+#define DISPLAY_AS_WARNING_FLAG ( 1 << 6 )
+
+#define INVALID_RESULT_INDEX 0xFFFFFFFFFFFFFFFFull
+
+class LOGICAPI Frame
+{
+  public:
+    Frame();
+    Frame( const Frame& frame );
+    ~Frame();
+
+    S64 mStartingSampleInclusive;
+    S64 mEndingSampleInclusive;
+    U64 mData1;
+    U64 mData2;
+    U8 mType;
+    U8 mFlags;
+
+    bool HasFlag( U8 flag );
+};
+
+// Stand-in only: one key/value pair recorded by FrameV2.
+struct FrameV2Entry
+{
+    enum Kind
+    {
+        String,
+        Double,
+        Integer,
+        Boolean,
+        Byte,
+        ByteArray
+    };
+
+    std::string mKey;
+    Kind mKind;
+    std::string mString;
+    double mDouble;
+    S64 mInteger;
+    std::vector<U8> mBytes;
+};
+
+class LOGICAPI FrameV2
+{
+  public:
+    FrameV2();
+    ~FrameV2();
+
+    void AddString( const char* key, const char* value );
+    void AddDouble( const char* key, double value );
+    void AddInteger( const char* key, S64 value );
+    void AddBoolean( const char* key, bool value );
+    void AddByte( const char* key, U8 value );
+    void AddByteArray( const char* key, const U8* data, U64 length );
+
+    // Stand-in only. With sKeepEntries off the Add functions record nothing, and so allocate nothing, which lets a test see
+    // the analyzer's own allocations.
+    std::vector<FrameV2Entry> mEntries;
+    const FrameV2Entry* Find( const char* key ) const;
+    static bool sKeepEntries;
+};
+
+class LOGICAPI AnalyzerResults
+{
+  public:
+    enum MarkerType
+    {
+        Dot,
+        ErrorDot,
+        Square,
+        ErrorSquare,
+        UpArrow,
+        DownArrow,
+        X,
+        ErrorX,
+        Start,
+        Stop,
+        One,
+        Zero
+    };
+
+    AnalyzerResults();
+    virtual ~AnalyzerResults();
+
+    // override:
+    virtual void GenerateBubbleText( U64 frame_index, Channel& channel, DisplayBase display_base ) = 0;
+    virtual void GenerateExportFile( const char* file, DisplayBase display_base, U32 export_type_user_id ) = 0;
+    virtual void GenerateFrameTabularText( U64 frame_index, DisplayBase display_base ) = 0;
+    virtual void GeneratePacketTabularText( U64 packet_id, DisplayBase display_base ) = 0;
+    virtual void GenerateTransactionTabularText( U64 transaction_id, DisplayBase display_base ) = 0;
+
+    // use:
+    void AddMarker( U64 sample_number, MarkerType marker_type, Channel& channel );
+
+    U64 AddFrame( const Frame& frame );
+    void AddFrameV2( const FrameV2& frame, const char* type, U64 starting_sample, U64 ending_sample );
+    U64 CommitPacketAndStartNewPacket();
+    void CancelPacketAndStartNewPacket();
+    void AddPacketToTransaction( U64 transaction_id, U64 packet_id );
+    void AddChannelBubblesWillAppearOn( const Channel& channel );
+
+    void CommitResults();
+
+    U64 GetNumFrames();
+    U64 GetNumPackets();
+    Frame GetFrame( U64 frame_id );
+
+    U64 GetPacketContainingFrame( U64 frame_id );
+    U64 GetPacketContainingFrameSequential( U64 frame_id );
+    void GetFramesContainedInPacket( U64 packet_id, U64* first_frame_id, U64* last_frame_id );
+
+    U32 GetTransactionContainingPacket( U64 packet_id );
+    void GetPacketsContainedInTransaction( U64 transaction_id, U64** packet_id_array, U64* packet_id_count );
+
+    void ClearTabularText();
+    void AddTabularText( const char* str1, const char* str2 = NULL, const char* str3 = NULL, const char* str4 = NULL,
+                         const char* str5 = NULL, const char* str6 = NULL );
+
+    void ClearResultStrings();
+    void AddResultString( const char* str1, const char* str2 = NULL, const char* str3 = NULL, const char* str4 = NULL,
+                          const char* str5 = NULL, const char* str6 = NULL );
+
+    bool UpdateExportProgressAndCheckForCancel( U64 completed_frames, U64 total_frames );
+
+    // Stand-in only: everything the analyzer emitted, for inspection by tests and benchmarks.
+    struct Marker
+    {
+        U64 mSample;
+        MarkerType mType;
+    };
+
+    struct FrameV2Record
+    {
+        std::string mType;
+        U64 mStartingSample;
+        U64 mEndingSample;
+        FrameV2 mFrame;
+    };
+
+    std::vector<Frame> mFrames;
+    std::vector<FrameV2Record> mFramesV2;
+    std::vector<Marker> mMarkers;
+    std::vector<std::pair<U64, U64> > mPackets; // first/last frame index
+    std::vector<std::string> mResultStrings;
+    std::vector<std::string> mTabularText;
+    U64 mCommitCount;
+    U64 mPacketStart;
+    bool mKeepFramesV2; // benchmarks turn this off to measure the decoder rather than the stand-in
+    U64 mFramesV2Count;
+    U64 mCancelExportAfter;
+};
+
+#endif // ANALYZERRESULTS
@@ -0,0 +1,43 @@
+#ifndef ANALYZER_SETTINGS
+#define ANALYZER_SETTINGS
+
+#include "LogicPublicTypes.h"
+#include "AnalyzerTypes.h"
+#include "AnalyzerSettingInterface.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+class LOGICAPI AnalyzerSettings
+{
+  public:
+    AnalyzerSettings();
+    virtual ~AnalyzerSettings();
+
+    // Implement
+    virtual bool SetSettingsFromInterfaces() = 0;
+    virtual void LoadSettings( const char* settings ) = 0;
+    virtual const char* SaveSettings() = 0;
+
+    // Use, but don't override/implement
+    void ClearChannels();
+    void AddChannel( Channel& channel, const char* channel_label, bool is_used );
+
+    void SetErrorText( const char* error_text );
+    void AddInterface( AnalyzerSettingInterface* analyzer_setting_interface );
+
+    void AddExportOption( U32 user_id, const char* menu_text );
+    void AddExportExtension( U32 user_id, const char* extension_description, const char* extension );
+
+    const char* SetReturnString( const char* str );
+
+    // Stand-in only.
+    std::vector<AnalyzerSettingInterface*> mInterfaces;
+    std::vector<std::pair<U32, std::string> > mExportOptions;
+    std::string mErrorText;
+
+  protected:
+    std::string mReturnString;
+};
+
+#endif // ANALYZER_SETTINGS
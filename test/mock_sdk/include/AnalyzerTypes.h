@@ -0,0 +1,35 @@
+#ifndef ANALYZER_TYPES
+#define ANALYZER_TYPES
+
+#include "LogicPublicTypes.h"
+
+#define ANALYZER_EXPORT
+
+enum ChannelDataType
+{
+    ANALOG_CHANNEL,
+    DIGITAL_CHANNEL
+};
+
+class LOGICAPI Channel
+{
+  public:
+    Channel();
+    Channel( const Channel& channel );
+    Channel( U64 device_id, U32 channel_index, ChannelDataType data_type );
+    ~Channel();
+
+    Channel& operator=( const Channel& channel );
+    bool operator==( const Channel& channel ) const;
+    bool operator!=( const Channel& channel ) const;
+    bool operator>( const Channel& channel ) const;
+    bool operator<( const Channel& channel ) const;
+
+    U64 mDeviceId;
+    U32 mChannelIndex;
+    ChannelDataType mDataType;
+};
+
+#define UNDEFINED_CHANNEL Channel( 0xFFFFFFFFFFFFFFFFull, 0xFFFFFFFF, ANALOG_CHANNEL )
+
+#endif // ANALYZER_TYPES
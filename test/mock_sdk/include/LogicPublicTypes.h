@@ -0,0 +1,43 @@
+#ifndef LOGICPUBLICTYPES
+#define LOGICPUBLICTYPES
+
+// Offline stand-in for the Saleae AnalyzerSDK header of the same name. Only the subset used by this
+// analyzer is provided.
+
+#ifndef WIN32
+#define __cdecl
+#define __stdcall
+#define __fastcall
+#endif
+
+#define LOGICAPI
+
+typedef signed char S8;
+typedef short S16;
+typedef int S32;
+typedef long long int S64;
+
+typedef unsigned char U8;
+typedef unsigned short U16;
+typedef unsigned int U32;
+typedef unsigned long long int U64;
+
+enum DisplayBase
+{
+    Binary,
+    Decimal,
+    Hexadecimal,
+    ASCII,
+    AsciiHex
+};
+
+enum BitState
+{
+    BIT_LOW,
+    BIT_HIGH
+};
+
+#define Toggle( x ) ( x == BIT_LOW ? BIT_HIGH : BIT_LOW )
+#define Invert( x ) Toggle( x )
+
+#endif // LOGICPUBLICTYPES
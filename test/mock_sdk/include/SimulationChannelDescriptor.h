@@ -0,0 +1,42 @@
+#ifndef SIMULATION_CHANNEL_DESCRIPTOR
+#define SIMULATION_CHANNEL_DESCRIPTOR
+
+#include "LogicPublicTypes.h"
+#include "AnalyzerTypes.h"
+#include <vector>
+
+class LOGICAPI SimulationChannelDescriptor
+{
+  public:
+    void Transition();
+    void TransitionIfNeeded( BitState bit_state );
+    void Advance( U32 num_samples_to_advance );
+
+    BitState GetCurrentBitState();
+    U64 GetCurrentSampleNumber();
+
+    SimulationChannelDescriptor();
+    SimulationChannelDescriptor( const SimulationChannelDescriptor& other );
+    ~SimulationChannelDescriptor();
+    SimulationChannelDescriptor& operator=( const SimulationChannelDescriptor& other );
+
+    void SetChannel( Channel& channel );
+    void SetSampleRate( U32 sample_rate_hz );
+    void SetInitialBitState( BitState intial_bit_state );
+
+    Channel GetChannel();
+    U32 GetSampleRate();
+    BitState GetInitialBitState();
+
+    // Stand-in only: the transitions generated so far.
+    std::vector<U64> mEdges;
+
+  protected:
+    Channel mChannel;
+    U32 mSampleRate;
+    BitState mInitialBitState;
+    BitState mCurrentBitState;
+    U64 mCurrentSample;
+};
+
+#endif // SIMULATION_CHANNEL_DESCRIPTOR
@@ -0,0 +1,106 @@
+#include <Analyzer.h>
+
+Analyzer::Analyzer()
+    : mLastProgressSample( 0 ),
+      mProgressReports( 0 ),
+      mAnalyzerSettings( NULL ),
+      mAnalyzerResults( NULL ),
+      mSampleRateHz( 1000000 ),
+      mSimulationSampleRateHz( 1000000 ),
+      mTriggerSample( 0 )
+{
+}
+
+Analyzer::~Analyzer()
+{
+}
+
+void Analyzer::SetAnalyzerSettings( AnalyzerSettings* settings )
+{
+    mAnalyzerSettings = settings;
+}
+
+void Analyzer::KillThread()
+{
+}
+
+AnalyzerChannelData* Analyzer::GetAnalyzerChannelData( Channel& channel )
+{
+    std::map<Channel, AnalyzerChannelData*>::iterator it = mChannelData.find( channel );
+    if( it == mChannelData.end() )
+        throw AnalyzerChannelDataExhausted();
+    return it->second;
+}
+
+void Analyzer::ReportProgress( U64 sample_number )
+{
+    mLastProgressSample = sample_number;
+    ++mProgressReports;
+}
+
+void Analyzer::SetAnalyzerResults( AnalyzerResults* results )
+{
+    mAnalyzerResults = results;
+}
+
+U32 Analyzer::GetSimulationSampleRate()
+{
+    return mSimulationSampleRateHz;
+}
+
+U32 Analyzer::GetSampleRate()
+{
+    return mSampleRateHz;
+}
+
+U64 Analyzer::GetTriggerSample()
+{
+    return mTriggerSample;
+}
+
+void Analyzer::CheckIfThreadShouldExit()
+{
+}
+
+void Analyzer::UseFrameV2()
+{
+}
+
+void Analyzer::SetChannelData( const Channel& channel, AnalyzerChannelData* data )
+{
+    mChannelData[ channel ] = data;
+}
+
+void Analyzer::SetSampleRate( U32 sample_rate_hz )
+{
+    mSampleRateHz = sample_rate_hz;
+}
+
+void Analyzer::SetSimulationSampleRate( U32 sample_rate_hz )
+{
+    mSimulationSampleRateHz = sample_rate_hz;
+}
+
+void Analyzer::SetTriggerSample( U64 trigger_sample )
+{
+    mTriggerSample = trigger_sample;
+}
+
+void Analyzer::RunToCompletion()
+{
+    try
+    {
+        WorkerThread();
+    }
+    catch( const AnalyzerChannelDataExhausted& )
+    {
+    }
+}
+
+Analyzer2::Analyzer2()
+{
+}
+
+void Analyzer2::SetupResults()
+{
+}
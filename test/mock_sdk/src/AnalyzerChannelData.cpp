@@ -0,0 +1,107 @@
+#include <AnalyzerChannelData.h>
+#include <algorithm>
+
+AnalyzerChannelData::AnalyzerChannelData( BitState initial_state, const std::vector<U64>& edges, U64 end_sample )
+    : mEdges( edges ),
+      mEndSample( end_sample ),
+      mSampleNumber( 0 ),
+      mNextEdgeIndex( 0 ),
+      mInitialState( initial_state ),
+      mBitState( initial_state ),
+      mCallCount( 0 )
+{
+}
+
+AnalyzerChannelData::~AnalyzerChannelData()
+{
+}
+
+U64 AnalyzerChannelData::GetSampleNumber()
+{
+    ++mCallCount;
+    return mSampleNumber;
+}
+
+BitState AnalyzerChannelData::GetBitState()
+{
+    ++mCallCount;
+    return mBitState;
+}
+
+void AnalyzerChannelData::MoveTo( U64 sample_number )
+{
+    if( sample_number > mEndSample )
+        throw AnalyzerChannelDataExhausted();
+
+    while( mNextEdgeIndex < mEdges.size() && mEdges[ mNextEdgeIndex ] <= sample_number )
+    {
+        ++mNextEdgeIndex;
+        mBitState = Toggle( mBitState );
+    }
+    mSampleNumber = sample_number;
+}
+
+U32 AnalyzerChannelData::Advance( U32 num_samples )
+{
+    ++mCallCount;
+    size_t before = mNextEdgeIndex;
+    MoveTo( mSampleNumber + num_samples );
+    return U32( mNextEdgeIndex - before );
+}
+
+U32 AnalyzerChannelData::AdvanceToAbsPosition( U64 sample_number )
+{
+    ++mCallCount;
+    size_t before = mNextEdgeIndex;
+    if( sample_number > mSampleNumber )
+        MoveTo( sample_number );
+    return U32( mNextEdgeIndex - before );
+}
+
+void AnalyzerChannelData::AdvanceToNextEdge()
+{
+    ++mCallCount;
+    if( mNextEdgeIndex >= mEdges.size() )
+        throw AnalyzerChannelDataExhausted();
+    MoveTo( mEdges[ mNextEdgeIndex ] );
+}
+
+U64 AnalyzerChannelData::GetSampleOfNextEdge()
+{
+    ++mCallCount;
+    if( mNextEdgeIndex >= mEdges.size() )
+        throw AnalyzerChannelDataExhausted();
+    return mEdges[ mNextEdgeIndex ];
+}
+
+bool AnalyzerChannelData::WouldAdvancingCauseTransition( U32 num_samples )
+{
+    ++mCallCount;
+    return mNextEdgeIndex < mEdges.size() && mEdges[ mNextEdgeIndex ] <= mSampleNumber + num_samples;
+}
+
+bool AnalyzerChannelData::WouldAdvancingToAbsPositionCauseTransition( U64 sample_number )
+{
+    ++mCallCount;
+    return mNextEdgeIndex < mEdges.size() && mEdges[ mNextEdgeIndex ] <= sample_number;
+}
+
+void AnalyzerChannelData::TrackMinimumPulseWidth()
+{
+}
+
+U64 AnalyzerChannelData::GetMinimumPulseWidthSoFar()
+{
+    return 0;
+}
+
+bool AnalyzerChannelData::DoMoreTransitionsExistInCurrentData()
+{
+    ++mCallCount;
+    return mNextEdgeIndex < mEdges.size();
+}
+
+U64 AnalyzerChannelData::GetCallCount() const
+{
+    return mCallCount;
+}
@@ -0,0 +1,287 @@
+#include <AnalyzerHelpers.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+bool AnalyzerHelpers::IsEven( U64 value )
+{
+    return ( value & 1 ) == 0;
+}
+
+bool AnalyzerHelpers::IsOdd( U64 value )
+{
+    return ( value & 1 ) != 0;
+}
+
+U32 AnalyzerHelpers::GetOnesCount( U64 value )
+{
+    U32 count = 0;
+    for( ; value != 0; value &= value - 1 )
+        ++count;
+    return count;
+}
+
+U32 AnalyzerHelpers::Diff32( U32 a, U32 b )
+{
+    return a > b ? a - b : b - a;
+}
+
+void AnalyzerHelpers::GetNumberString( U64 number, DisplayBase display_base, U32 num_data_bits, char* result_string,
+                                       U32 result_string_max_length )
+{
+    switch( display_base )
+    {
+    case Binary:
+    {
+        std::string bits = "0b";
+        for( U32 i = num_data_bits; i > 0; --i )
+            bits += ( ( number >> ( i - 1 ) ) & 1 ) ? '1' : '0';
+        snprintf( result_string, result_string_max_length, "%s", bits.c_str() );
+    }
+    break;
+    case Decimal:
+        snprintf( result_string, result_string_max_length, "%llu", number );
+        break;
+    case ASCII:
+        if( number >= 0x20 && number < 0x7F )
+            snprintf( result_string, result_string_max_length, "%c", char( number ) );
+        else
+            snprintf( result_string, result_string_max_length, "'%llu'", number );
+        break;
+    case AsciiHex:
+        if( number >= 0x20 && number < 0x7F )
+            snprintf( result_string, result_string_max_length, "'%c' (0x%0*llX)", char( number ), int( ( num_data_bits + 3 ) / 4 ),
+                      number );
+        else
+            snprintf( result_string, result_string_max_length, "0x%0*llX", int( ( num_data_bits + 3 ) / 4 ), number );
+        break;
+    case Hexadecimal:
+    default:
+        snprintf( result_string, result_string_max_length, "0x%0*llX", int( ( num_data_bits + 3 ) / 4 ), number );
+        break;
+    }
+}
+
+void AnalyzerHelpers::GetTimeString( U64 sample, U64 trigger_sample, U32 sample_rate_hz, char* result_string,
+                                     U32 result_string_max_length )
+{
+    int precision = 0;
+    for( U64 scale = 1; scale < sample_rate_hz; scale *= 10 )
+        ++precision;
+    double seconds = double( S64( sample - trigger_sample ) ) / double( sample_rate_hz );
+    snprintf( result_string, result_string_max_length, "%.*f", precision, seconds );
+}
+
+void AnalyzerHelpers::Assert( const char* message )
+{
+    fprintf( stderr, "Assert: %s\n", message );
+    abort();
+}
+
+U64 AnalyzerHelpers::AdjustSimulationTargetSample( U64 target_sample, U32 sample_rate, U32 simulation_sample_rate )
+{
+    if( sample_rate == simulation_sample_rate )
+        return target_sample;
+    return U64( double( target_sample ) * double( simulation_sample_rate ) / double( sample_rate ) );
+}
+
+bool AnalyzerHelpers::DoesFileExist( const char* file )
+{
+    FILE* f = fopen( file, "rb" );
+    if( f == NULL )
+        return false;
+    fclose( f );
+    return true;
+}
+
+void* AnalyzerHelpers::StartFile( const char* file, bool append )
+{
+    return fopen( file, append ? "ab" : "wb" );
+}
+
+void AnalyzerHelpers::AppendToFile( const U8* data, U32 data_length, void* file )
+{
+    fwrite( data, 1, data_length, static_cast<FILE*>( file ) );
+}
+
+void AnalyzerHelpers::EndFile( void* file )
+{
+    fclose( static_cast<FILE*>( file ) );
+}
+
+S64 AnalyzerHelpers::ConvertToSignedNumber( U64 number, U32 num_bits )
+{
+    if( num_bits == 0 || num_bits >= 64 )
+        return S64( number );
+    U64 sign = 1ull << ( num_bits - 1 );
+    return S64( ( number ^ sign ) - sign );
+}
+
+// Tokens are stored as "<length>:<text>" separated by spaces so text settings may contain spaces.
+SimpleArchive::SimpleArchive() : mReadIndex( 0 )
+{
+}
+
+SimpleArchive::~SimpleArchive()
+{
+}
+
+void SimpleArchive::SetString( const char* archive_string )
+{
+    mTokens.clear();
+    mReadIndex = 0;
+    const char* p = archive_string;
+    while( p != NULL && *p != 0 )
+    {
+        while( *p == ' ' )
+            ++p;
+        if( *p == 0 )
+            break;
+        char* colon = NULL;
+        unsigned long length = strtoul( p, &colon, 10 );
+        if( colon == NULL || *colon != ':' )
+            break;
+        mTokens.push_back( std::string( colon + 1, length ) );
+        p = colon + 1 + length;
+    }
+}
+
+const char* SimpleArchive::GetString()
+{
+    mString.clear();
+    for( size_t i = 0; i < mTokens.size(); ++i )
+    {
+        char prefix[ 32 ];
+        snprintf( prefix, sizeof( prefix ), "%s%u:", i ? " " : "", unsigned( mTokens[ i ].size() ) );
+        mString += prefix;
+        mString += mTokens[ i ];
+    }
+    return mString.c_str();
+}
+
+namespace
+{
+    template <typename T>
+    std::string ToToken( const char* format, T value )
+    {
+        char buffer[ 64 ];
+        snprintf( buffer, sizeof( buffer ), format, value );
+        return buffer;
+    }
+}
+
+bool SimpleArchive::operator<<( U64 data )
+{
+    mTokens.push_back( ToToken( "%llu", data ) );
+    return true;
+}
+
+bool SimpleArchive::operator<<( U32 data )
+{
+    mTokens.push_back( ToToken( "%u", data ) );
+    return true;
+}
+
+bool SimpleArchive::operator<<( S64 data )
+{
+    mTokens.push_back( ToToken( "%lld", data ) );
+    return true;
+}
+
+bool SimpleArchive::operator<<( S32 data )
+{
+    mTokens.push_back( ToToken( "%d", data ) );
+    return true;
+}
+
+bool SimpleArchive::operator<<( double data )
+{
+    mTokens.push_back( ToToken( "%.17g", data ) );
+    return true;
+}
+
+bool SimpleArchive::operator<<( bool data )
+{
+    mTokens.push_back( data ? "1" : "0" );
+    return true;
+}
+
+bool SimpleArchive::operator<<( const char* data )
+{
+    mTokens.push_back( data );
+    return true;
+}
+
+bool SimpleArchive::operator<<( Channel& data )
+{
+    *this << data.mDeviceId;
+    *this << data.mChannelIndex;
+    *this << U32( data.mDataType );
+    return true;
+}
+
+bool SimpleArchive::operator>>( U64& data )
+{
+    if( mReadIndex >= mTokens.size() )
+        return false;
+    data = strtoull( mTokens[ mReadIndex++ ].c_str(), NULL, 10 );
+    return true;
+}
+
+bool SimpleArchive::operator>>( U32& data )
+{
+    if( mReadIndex >= mTokens.size() )
+        return false;
+    data = U32( strtoul( mTokens[ mReadIndex++ ].c_str(), NULL, 10 ) );
+    return true;
+}
+
+bool SimpleArchive::operator>>( S64& data )
+{
+    if( mReadIndex >= mTokens.size() )
+        return false;
+    data = strtoll( mTokens[ mReadIndex++ ].c_str(), NULL, 10 );
+    return true;
+}
+
+bool SimpleArchive::operator>>( S32& data )
+{
+    if( mReadIndex >= mTokens.size() )
+        return false;
+    data = S32( strtol( mTokens[ mReadIndex++ ].c_str(), NULL, 10 ) );
+    return true;
+}
+
+bool SimpleArchive::operator>>( double& data )
+{
+    if( mReadIndex >= mTokens.size() )
+        return false;
+    data = strtod( mTokens[ mReadIndex++ ].c_str(), NULL );
+    return true;
+}
+
+bool SimpleArchive::operator>>( bool& data )
+{
+    if( mReadIndex >= mTokens.size() )
+        return false;
+    data = mTokens[ mReadIndex++ ] != "0";
+    return true;
+}
+
+bool SimpleArchive::operator>>( char const** data )
+{
+    if( mReadIndex >= mTokens.size() )
+        return false;
+    mLastString = mTokens[ mReadIndex++ ];
+    *data = mLastString.c_str();
+    return true;
+}
+
+bool SimpleArchive::operator>>( Channel& data )
+{
+    U32 data_type = 0;
+    if( !( *this >> data.mDeviceId ) || !( *this >> data.mChannelIndex ) || !( *this >> data_type ) )
+        return false;
+    data.mDataType = ChannelDataType( data_type );
+    return true;
+}
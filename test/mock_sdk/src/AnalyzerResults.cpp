@@ -0,0 +1,245 @@
+#include <AnalyzerResults.h>
+#include <string.h>
+
+Frame::Frame() : mStartingSampleInclusive( 0 ), mEndingSampleInclusive( 0 ), mData1( 0 ), mData2( 0 ), mType( 0 ), mFlags( 0 )
+{
+}
+
+Frame::Frame( const Frame& frame ) = default;
+
+Frame::~Frame()
+{
+}
+
+bool Frame::HasFlag( U8 flag )
+{
+    return ( mFlags & flag ) != 0;
+}
+
+bool FrameV2::sKeepEntries = true;
+
+FrameV2::FrameV2()
+{
+}
+
+FrameV2::~FrameV2()
+{
+}
+
+namespace
+{
+    FrameV2Entry& NewEntry( std::vector<FrameV2Entry>& entries, const char* key, FrameV2Entry::Kind kind )
+    {
+        entries.push_back( FrameV2Entry() );
+        FrameV2Entry& entry = entries.back();
+        entry.mKey = key;
+        entry.mKind = kind;
+        entry.mDouble = 0;
+        entry.mInteger = 0;
+        return entry;
+    }
+}
+
+void FrameV2::AddString( const char* key, const char* value )
+{
+    if( !sKeepEntries )
+        return;
+    NewEntry( mEntries, key, FrameV2Entry::String ).mString = value;
+}
+
+void FrameV2::AddDouble( const char* key, double value )
+{
+    if( !sKeepEntries )
+        return;
+    NewEntry( mEntries, key, FrameV2Entry::Double ).mDouble = value;
+}
+
+void FrameV2::AddInteger( const char* key, S64 value )
+{
+    if( !sKeepEntries )
+        return;
+    NewEntry( mEntries, key, FrameV2Entry::Integer ).mInteger = value;
+}
+
+void FrameV2::AddBoolean( const char* key, bool value )
+{
+    if( !sKeepEntries )
+        return;
+    NewEntry( mEntries, key, FrameV2Entry::Boolean ).mInteger = value ? 1 : 0;
+}
+
+void FrameV2::AddByte( const char* key, U8 value )
+{
+    if( !sKeepEntries )
+        return;
+    NewEntry( mEntries, key, FrameV2Entry::Byte ).mInteger = value;
+}
+
+void FrameV2::AddByteArray( const char* key, const U8* data, U64 length )
+{
+    if( !sKeepEntries )
+        return;
+    NewEntry( mEntries, key, FrameV2Entry::ByteArray ).mBytes.assign( data, data + length );
+}
+
+const FrameV2Entry* FrameV2::Find( const char* key ) const
+{
+    for( size_t i = 0; i < mEntries.size(); ++i )
+    {
+        if( mEntries[ i ].mKey == key )
+            return &mEntries[ i ];
+    }
+    return NULL;
+}
+
+AnalyzerResults::AnalyzerResults()
+    : mCommitCount( 0 ), mPacketStart( 0 ), mKeepFramesV2( true ), mFramesV2Count( 0 ), mCancelExportAfter( INVALID_RESULT_INDEX )
+{
+}
+
+AnalyzerResults::~AnalyzerResults()
+{
+}
+
+void AnalyzerResults::AddMarker( U64 sample_number, MarkerType marker_type, Channel& /*channel*/ )
+{
+    Marker marker;
+    marker.mSample = sample_number;
+    marker.mType = marker_type;
+    mMarkers.push_back( marker );
+}
+
+U64 AnalyzerResults::AddFrame( const Frame& frame )
+{
+    mFrames.push_back( frame );
+    return mFrames.size() - 1;
+}
+
+void AnalyzerResults::AddFrameV2( const FrameV2& frame, const char* type, U64 starting_sample, U64 ending_sample )
+{
+    ++mFramesV2Count;
+    if( !mKeepFramesV2 )
+        return;
+    FrameV2Record record;
+    record.mType = type;
+    record.mStartingSample = starting_sample;
+    record.mEndingSample = ending_sample;
+    record.mFrame = frame;
+    mFramesV2.push_back( record );
+}
+
+U64 AnalyzerResults::CommitPacketAndStartNewPacket()
+{
+    if( mPacketStart >= mFrames.size() )
+        return INVALID_RESULT_INDEX;
+    mPackets.push_back( std::make_pair( mPacketStart, U64( mFrames.size() - 1 ) ) );
+    mPacketStart = mFrames.size();
+    return mPackets.size() - 1;
+}
+
+void AnalyzerResults::CancelPacketAndStartNewPacket()
+{
+    mPacketStart = mFrames.size();
+}
+
+void AnalyzerResults::AddPacketToTransaction( U64 /*transaction_id*/, U64 /*packet_id*/ )
+{
+}
+
+void AnalyzerResults::AddChannelBubblesWillAppearOn( const Channel& /*channel*/ )
+{
+}
+
+void AnalyzerResults::CommitResults()
+{
+    ++mCommitCount;
+}
+
+U64 AnalyzerResults::GetNumFrames()
+{
+    return mFrames.size();
+}
+
+U64 AnalyzerResults::GetNumPackets()
+{
+    return mPackets.size();
+}
+
+Frame AnalyzerResults::GetFrame( U64 frame_id )
+{
+    return mFrames.at( frame_id );
+}
+
+U64 AnalyzerResults::GetPacketContainingFrame( U64 frame_id )
+{
+    size_t lo = 0;
+    size_t hi = mPackets.size();
+    while( lo < hi )
+    {
+        size_t mid = ( lo + hi ) / 2;
+        if( mPackets[ mid ].second < frame_id )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if( lo < mPackets.size() && mPackets[ lo ].first <= frame_id )
+        return lo;
+    return INVALID_RESULT_INDEX;
+}
+
+U64 AnalyzerResults::GetPacketContainingFrameSequential( U64 frame_id )
+{
+    return GetPacketContainingFrame( frame_id );
+}
+
+void AnalyzerResults::GetFramesContainedInPacket( U64 packet_id, U64* first_frame_id, U64* last_frame_id )
+{
+    *first_frame_id = mPackets.at( packet_id ).first;
+    *last_frame_id = mPackets.at( packet_id ).second;
+}
+
+U32 AnalyzerResults::GetTransactionContainingPacket( U64 /*packet_id*/ )
+{
+    return 0;
+}
+
+void AnalyzerResults::GetPacketsContainedInTransaction( U64 /*transaction_id*/, U64** packet_id_array, U64* packet_id_count )
+{
+    *packet_id_array = NULL;
+    *packet_id_count = 0;
+}
+
+void AnalyzerResults::ClearTabularText()
+{
+    mTabularText.clear();
+}
+
+void AnalyzerResults::AddTabularText( const char* str1, const char* str2, const char* str3, const char* str4, const char* str5,
+                                      const char* str6 )
+{
+    std::string text;
+    const char* strs[] = { str1, str2, str3, str4, str5, str6 };
+    for( size_t i = 0; i < 6 && strs[ i ] != NULL; ++i )
+        text += strs[ i ];
+    mTabularText.push_back( text );
+}
+
+void AnalyzerResults::ClearResultStrings()
+{
+    mResultStrings.clear();
+}
+
+void AnalyzerResults::AddResultString( const char* str1, const char* str2, const char* str3, const char* str4, const char* str5,
+                                       const char* str6 )
+{
+    std::string text;
+    const char* strs[] = { str1, str2, str3, str4, str5, str6 };
+    for( size_t i = 0; i < 6 && strs[ i ] != NULL; ++i )
+        text += strs[ i ];
+    mResultStrings.push_back( text );
+}
+
+bool AnalyzerResults::UpdateExportProgressAndCheckForCancel( U64 completed_frames, U64 total_frames )
+{
+    return total_frames != 0 && completed_frames >= mCancelExportAfter;
+}
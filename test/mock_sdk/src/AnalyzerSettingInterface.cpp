@@ -0,0 +1,256 @@
+#include <AnalyzerSettingInterface.h>
+#include <new>
+#include <stdlib.h>
+
+AnalyzerSettingInterface::AnalyzerSettingInterface()
+{
+}
+
+AnalyzerSettingInterface::~AnalyzerSettingInterface()
+{
+}
+
+void AnalyzerSettingInterface::operator delete( void* p )
+{
+    ::operator delete( p );
+}
+
+void* AnalyzerSettingInterface::operator new( size_t size )
+{
+    return ::operator new( size );
+}
+
+AnalyzerInterfaceTypeId AnalyzerSettingInterface::GetType()
+{
+    return INTERFACE_BASE;
+}
+
+const char* AnalyzerSettingInterface::GetToolTip()
+{
+    return mTooltip.c_str();
+}
+
+const char* AnalyzerSettingInterface::GetTitle()
+{
+    return mTitle.c_str();
+}
+
+bool AnalyzerSettingInterface::IsDisabled()
+{
+    return false;
+}
+
+void AnalyzerSettingInterface::SetTitleAndTooltip( const char* title, const char* tooltip )
+{
+    mTitle = title;
+    mTooltip = tooltip;
+}
+
+AnalyzerSettingInterfaceChannel::AnalyzerSettingInterfaceChannel() : mSelectionOfNoneIsAllowed( false )
+{
+}
+
+AnalyzerSettingInterfaceChannel::~AnalyzerSettingInterfaceChannel()
+{
+}
+
+AnalyzerInterfaceTypeId AnalyzerSettingInterfaceChannel::GetType()
+{
+    return INTERFACE_CHANNEL;
+}
+
+Channel AnalyzerSettingInterfaceChannel::GetChannel()
+{
+    return mChannel;
+}
+
+void AnalyzerSettingInterfaceChannel::SetChannel( const Channel& channel )
+{
+    mChannel = channel;
+}
+
+bool AnalyzerSettingInterfaceChannel::GetSelectionOfNoneIsAllowed()
+{
+    return mSelectionOfNoneIsAllowed;
+}
+
+void AnalyzerSettingInterfaceChannel::SetSelectionOfNoneIsAllowed( bool is_allowed )
+{
+    mSelectionOfNoneIsAllowed = is_allowed;
+}
+
+AnalyzerSettingInterfaceNumberList::AnalyzerSettingInterfaceNumberList() : mNumber( 0 )
+{
+}
+
+AnalyzerSettingInterfaceNumberList::~AnalyzerSettingInterfaceNumberList()
+{
+}
+
+AnalyzerInterfaceTypeId AnalyzerSettingInterfaceNumberList::GetType()
+{
+    return INTERFACE_NUMBER_LIST;
+}
+
+double AnalyzerSettingInterfaceNumberList::GetNumber()
+{
+    return mNumber;
+}
+
+void AnalyzerSettingInterfaceNumberList::SetNumber( double number )
+{
+    mNumber = number;
+}
+
+U32 AnalyzerSettingInterfaceNumberList::GetListboxNumbersCount()
+{
+    return U32( mNumbers.size() );
+}
+
+double AnalyzerSettingInterfaceNumberList::GetListboxNumber( U32 index )
+{
+    return mNumbers.at( index );
+}
+
+U32 AnalyzerSettingInterfaceNumberList::GetListboxStringsCount()
+{
+    return U32( mStrings.size() );
+}
+
+const char* AnalyzerSettingInterfaceNumberList::GetListboxString( U32 index )
+{
+    return mStrings.at( index ).c_str();
+}
+
+U32 AnalyzerSettingInterfaceNumberList::GetListboxTooltipsCount()
+{
+    return U32( mTooltips.size() );
+}
+
+const char* AnalyzerSettingInterfaceNumberList::GetListboxTooltip( U32 index )
+{
+    return mTooltips.at( index ).c_str();
+}
+
+void AnalyzerSettingInterfaceNumberList::AddNumber( double number, const char* str, const char* tooltip )
+{
+    mNumbers.push_back( number );
+    mStrings.push_back( str );
+    mTooltips.push_back( tooltip );
+}
+
+void AnalyzerSettingInterfaceNumberList::ClearNumbers()
+{
+    mNumbers.clear();
+    mStrings.clear();
+    mTooltips.clear();
+}
+
+AnalyzerSettingInterfaceInteger::AnalyzerSettingInterfaceInteger() : mInteger( 0 ), mMax( 0x7FFFFFFF ), mMin( -0x7FFFFFFF )
+{
+}
+
+AnalyzerSettingInterfaceInteger::~AnalyzerSettingInterfaceInteger()
+{
+}
+
+AnalyzerInterfaceTypeId AnalyzerSettingInterfaceInteger::GetType()
+{
+    return INTERFACE_INTEGER;
+}
+
+int AnalyzerSettingInterfaceInteger::GetInteger()
+{
+    return mInteger;
+}
+
+void AnalyzerSettingInterfaceInteger::SetInteger( int integer )
+{
+    mInteger = integer;
+}
+
+int AnalyzerSettingInterfaceInteger::GetMax()
+{
+    return mMax;
+}
+
+int AnalyzerSettingInterfaceInteger::GetMin()
+{
+    return mMin;
+}
+
+void AnalyzerSettingInterfaceInteger::SetMax( int max )
+{
+    mMax = max;
+}
+
+void AnalyzerSettingInterfaceInteger::SetMin( int min )
+{
+    mMin = min;
+}
+
+AnalyzerSettingInterfaceText::AnalyzerSettingInterfaceText() : mTextType( NormalText )
+{
+}
+
+AnalyzerSettingInterfaceText::~AnalyzerSettingInterfaceText()
+{
+}
+
+AnalyzerInterfaceTypeId AnalyzerSettingInterfaceText::GetType()
+{
+    return INTERFACE_TEXT;
+}
+
+const char* AnalyzerSettingInterfaceText::GetText()
+{
+    return mText.c_str();
+}
+
+void AnalyzerSettingInterfaceText::SetText( const char* text )
+{
+    mText = text;
+}
+
+AnalyzerSettingInterfaceText::TextType AnalyzerSettingInterfaceText::GetTextType()
+{
+    return mTextType;
+}
+
+void AnalyzerSettingInterfaceText::SetTextType( TextType text_type )
+{
+    mTextType = text_type;
+}
+
+AnalyzerSettingInterfaceBool::AnalyzerSettingInterfaceBool() : mValue( false )
+{
+}
+
+AnalyzerSettingInterfaceBool::~AnalyzerSettingInterfaceBool()
+{
+}
+
+AnalyzerInterfaceTypeId AnalyzerSettingInterfaceBool::GetType()
+{
+    return INTERFACE_BOOL;
+}
+
+bool AnalyzerSettingInterfaceBool::GetValue()
+{
+    return mValue;
+}
+
+void AnalyzerSettingInterfaceBool::SetValue( bool value )
+{
+    mValue = value;
+}
+
+const char* AnalyzerSettingInterfaceBool::GetCheckBoxText()
+{
+    return mCheckBoxText.c_str();
+}
+
+void AnalyzerSettingInterfaceBool::SetCheckBoxText( const char* text )
+{
+    mCheckBoxText = text;
+}
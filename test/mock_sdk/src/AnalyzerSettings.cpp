@@ -0,0 +1,42 @@
+#include <AnalyzerSettings.h>
+
+AnalyzerSettings::AnalyzerSettings()
+{
+}
+
+AnalyzerSettings::~AnalyzerSettings()
+{
+}
+
+void AnalyzerSettings::ClearChannels()
+{
+}
+
+void AnalyzerSettings::AddChannel( Channel& /*channel*/, const char* /*channel_label*/, bool /*is_used*/ )
+{
+}
+
+void AnalyzerSettings::SetErrorText( const char* error_text )
+{
+    mErrorText = error_text;
+}
+
+void AnalyzerSettings::AddInterface( AnalyzerSettingInterface* analyzer_setting_interface )
+{
+    mInterfaces.push_back( analyzer_setting_interface );
+}
+
+void AnalyzerSettings::AddExportOption( U32 user_id, const char* menu_text )
+{
+    mExportOptions.push_back( std::make_pair( user_id, std::string( menu_text ) ) );
+}
+
+void AnalyzerSettings::AddExportExtension( U32 /*user_id*/, const char* /*extension_description*/, const char* /*extension*/ )
+{
+}
+
+const char* AnalyzerSettings::SetReturnString( const char* str )
+{
+    mReturnString = str;
+    return mReturnString.c_str();
+}
@@ -0,0 +1,42 @@
+#include <AnalyzerTypes.h>
+
+Channel::Channel() : mDeviceId( 0 ), mChannelIndex( 0 ), mDataType( DIGITAL_CHANNEL )
+{
+}
+
+Channel::Channel( const Channel& channel ) = default;
+
+Channel::Channel( U64 device_id, U32 channel_index, ChannelDataType data_type )
+    : mDeviceId( device_id ), mChannelIndex( channel_index ), mDataType( data_type )
+{
+}
+
+Channel::~Channel()
+{
+}
+
+Channel& Channel::operator=( const Channel& channel ) = default;
+
+bool Channel::operator==( const Channel& channel ) const
+{
+    return mDeviceId == channel.mDeviceId && mChannelIndex == channel.mChannelIndex && mDataType == channel.mDataType;
+}
+
+bool Channel::operator!=( const Channel& channel ) const
+{
+    return !( *this == channel );
+}
+
+bool Channel::operator>( const Channel& channel ) const
+{
+    return channel < *this;
+}
+
+bool Channel::operator<( const Channel& channel ) const
+{
+    if( mDeviceId != channel.mDeviceId )
+        return mDeviceId < channel.mDeviceId;
+    if( mChannelIndex != channel.mChannelIndex )
+        return mChannelIndex < channel.mChannelIndex;
+    return mDataType < channel.mDataType;
+}
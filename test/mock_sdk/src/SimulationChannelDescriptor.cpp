@@ -0,0 +1,72 @@
+#include <SimulationChannelDescriptor.h>
+
+SimulationChannelDescriptor::SimulationChannelDescriptor()
+    : mChannel(), mSampleRate( 0 ), mInitialBitState( BIT_LOW ), mCurrentBitState( BIT_LOW ), mCurrentSample( 0 )
+{
+}
+
+SimulationChannelDescriptor::SimulationChannelDescriptor( const SimulationChannelDescriptor& other ) = default;
+
+SimulationChannelDescriptor& SimulationChannelDescriptor::operator=( const SimulationChannelDescriptor& other ) = default;
+
+SimulationChannelDescriptor::~SimulationChannelDescriptor()
+{
+}
+
+void SimulationChannelDescriptor::Transition()
+{
+    mEdges.push_back( mCurrentSample );
+    mCurrentBitState = Toggle( mCurrentBitState );
+}
+
+void SimulationChannelDescriptor::TransitionIfNeeded( BitState bit_state )
+{
+    if( bit_state != mCurrentBitState )
+        Transition();
+}
+
+void SimulationChannelDescriptor::Advance( U32 num_samples_to_advance )
+{
+    mCurrentSample += num_samples_to_advance;
+}
+
+BitState SimulationChannelDescriptor::GetCurrentBitState()
+{
+    return mCurrentBitState;
+}
+
+U64 SimulationChannelDescriptor::GetCurrentSampleNumber()
+{
+    return mCurrentSample;
+}
+
+void SimulationChannelDescriptor::SetChannel( Channel& channel )
+{
+    mChannel = channel;
+}
+
+void SimulationChannelDescriptor::SetSampleRate( U32 sample_rate_hz )
+{
+    mSampleRate = sample_rate_hz;
+}
+
+void SimulationChannelDescriptor::SetInitialBitState( BitState intial_bit_state )
+{
+    mInitialBitState = intial_bit_state;
+    mCurrentBitState = intial_bit_state;
+}
+
+Channel SimulationChannelDescriptor::GetChannel()
+{
+    return mChannel;
+}
+
+U32 SimulationChannelDescriptor::GetSampleRate()
+{
+    return mSampleRate;
+}
+
+BitState SimulationChannelDescriptor::GetInitialBitState()
+{
+    return mInitialBitState;
+}
@@ -0,0 +1,423 @@
+#include "LINCaptureEdges.h"
+#include "LINDecoder.h"
+#include "LINFrameTableReader.h"
+#include "LINFrameTableWriter.h"
+#include "LINMappedFile.h"
+#include <chrono>
+#include <fstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// lin_decode: decodes a capture outside Logic, with the analyzer's decoder and settings, into CSV or a binary LIN frame
+// table. The capture is memory mapped and read in place, and the output goes through fixed size buffers, so memory use
+// stays the same however long the capture is.
+// usage: lin_decode [--format timestamps|bits] [--sample-rate HZ] [--bit-rate BPS] [--lin-version V] [--ldf PATH]
+//                   [--output csv|table] CAPTURE OUTPUT
+//        lin_decode --verify [--lin-version V] [--ldf PATH] TABLE
+// --verify checks the checksums recorded in a frame table again, and exits with 3 if any are wrong.
+
+namespace
+{
+    const U32 DefaultTimestampSampleRate = 100000000; // 10 ns, well under the jitter of any LIN transceiver.
+    const size_t OutputBufferSize = 1 << 20;
+    const U32 SpoolRecordSize = 20;
+
+    // the longest line CsvOutput writes: a 20 digit second count and 8 data bytes. Every field has a fixed widest form, so
+    // no line is longer.
+    const char CsvLongestLine[] = "18446744073709551615.999999999,0xFF,8,FF FF FF FF FF FF FF FF,0xFF,0xFF\n";
+    const size_t CsvTimeSize = sizeof( "18446744073709551615.999999999," );
+    const char HexDigits[] = "0123456789ABCDEF";
+
+    char* PutHex( char* pos, U8 value )
+    {
+        pos[ 0 ] = HexDigits[ value >> 4 ];
+        pos[ 1 ] = HexDigits[ value & 0x0F ];
+        return pos + 2;
+    }
+
+    // where the LIN frames go, one record at a time.
+    class RecordOutput
+    {
+      public:
+        virtual ~RecordOutput()
+        {
+        }
+
+        virtual void Add( const LINFrameTableRecord& record ) = 0;
+        virtual bool Close() = 0; // false if any of the output failed to write.
+    };
+
+    // a fixed block of output, handed to the stream whenever it fills.
+    class BlockBuffer
+    {
+      public:
+        BlockBuffer( std::ofstream& stream ) : mStream( stream ), mBuffer( OutputBufferSize ), mUsed( 0 )
+        {
+        }
+
+        // space for up to `length` bytes; Commit() the ones used.
+        char* Reserve( size_t length )
+        {
+            if( mUsed + length > mBuffer.size() )
+                Flush();
+            return &mBuffer[ mUsed ];
+        }
+
+        void Commit( size_t length )
+        {
+            mUsed += length;
+        }
+
+        void Flush()
+        {
+            if( mUsed != 0 )
+                mStream.write( &mBuffer[ 0 ], std::streamsize( mUsed ) );
+            mUsed = 0;
+        }
+
+      private:
+        std::ofstream& mStream;
+        std::vector<char> mBuffer;
+        size_t mUsed;
+    };
+
+    // one line per LIN frame: its time from the start of the capture, then the ID, data and checksum in hex, and the flags
+    // as in the frame table. The ID and checksum are left empty when the frame ended without them.
+    class CsvOutput : public RecordOutput
+    {
+      public:
+        CsvOutput( U64 sample_rate ) : mBuffer( mFile ), mSampleRate( sample_rate )
+        {
+        }
+
+        bool Open( const char* path )
+        {
+            mFile.open( path, std::ios::out | std::ios::binary | std::ios::trunc );
+            if( !mFile )
+                return false;
+            const char header[] = "time,id,length,data,checksum,flags\n";
+            memcpy( mBuffer.Reserve( sizeof( header ) - 1 ), header, sizeof( header ) - 1 );
+            mBuffer.Commit( sizeof( header ) - 1 );
+            return true;
+        }
+
+        virtual void Add( const LINFrameTableRecord& record )
+        {
+            char* line = mBuffer.Reserve( sizeof( CsvLongestLine ) );
+            const U64 seconds = record.mTimestamp / mSampleRate;
+            const U64 nanoseconds = ( record.mTimestamp % mSampleRate ) * 1000000000ull / mSampleRate;
+            const int time_length = snprintf( line, CsvTimeSize, "%llu.%09llu,", seconds, nanoseconds );
+            char* pos = line + ( time_length > 0 && size_t( time_length ) < CsvTimeSize ? time_length : 0 );
+
+            if( record.mIdentifier != LINFrameTableNoID )
+            {
+                *pos++ = '0';
+                *pos++ = 'x';
+                pos = PutHex( pos, record.mIdentifier );
+            }
+            const U8 length = record.mLength < sizeof( record.mData ) ? record.mLength : U8( sizeof( record.mData ) );
+            *pos++ = ',';
+            *pos++ = char( '0' + length );
+            *pos++ = ',';
+            for( U32 i = 0; i < length; i++ )
+            {
+                if( i != 0 )
+                    *pos++ = ' ';
+                pos = PutHex( pos, record.mData[ i ] );
+            }
+            *pos++ = ',';
+            if( ( record.mFlags & LINFrameTableNoChecksum ) == 0 )
+            {
+                *pos++ = '0';
+                *pos++ = 'x';
+                pos = PutHex( pos, record.mChecksum );
+            }
+            *pos++ = ',';
+            *pos++ = '0';
+            *pos++ = 'x';
+            pos = PutHex( pos, record.mFlags );
+            *pos++ = '\n';
+            mBuffer.Commit( size_t( pos - line ) );
+        }
+
+        virtual bool Close()
+        {
+            mBuffer.Flush();
+            bool written = bool( mFile );
+            mFile.close();
+            return written && bool( mFile );
+        }
+
+      private:
+        std::ofstream mFile;
+        BlockBuffer mBuffer;
+        U64 mSampleRate;
+    };
+
+    // the frame table needs the number of frames of each ID before any are written, so the records are spooled to a file
+    // next to the output while the capture is decoded, then mapped back in and written out as the table.
+    class TableOutput : public RecordOutput
+    {
+      public:
+        TableOutput( U64 sample_rate ) : mBuffer( mSpool ), mSampleRate( sample_rate )
+        {
+            memset( mIDCounts, 0, sizeof( mIDCounts ) );
+        }
+
+        bool Open( const char* path )
+        {
+            mPath = path;
+            mSpoolPath = mPath + ".spool";
+            mSpool.open( mSpoolPath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+            return bool( mSpool );
+        }
+
+        virtual void Add( const LINFrameTableRecord& record )
+        {
+            U8* spooled = reinterpret_cast<U8*>( mBuffer.Reserve( SpoolRecordSize ) );
+            memcpy( &spooled[ 0 ], &record.mTimestamp, 8 );
+            spooled[ 8 ] = record.mIdentifier;
+            spooled[ 9 ] = record.mLength;
+            memcpy( &spooled[ 10 ], record.mData, 8 );
+            spooled[ 18 ] = record.mChecksum;
+            spooled[ 19 ] = record.mFlags;
+            mBuffer.Commit( SpoolRecordSize );
+            ++mIDCounts[ LINFrameTableWriter::GetIndexEntry( record.mIdentifier ) ];
+        }
+
+        virtual bool Close()
+        {
+            mBuffer.Flush();
+            bool written = bool( mSpool );
+            mSpool.close();
+            written = written && bool( mSpool ) && WriteTable();
+            remove( mSpoolPath.c_str() );
+            return written;
+        }
+
+      private:
+        bool WriteTable()
+        {
+            LINMappedFile spool;
+            LINFrameTableWriter writer;
+            if( !spool.Open( mSpoolPath.c_str() ) || !writer.Open( mPath.c_str(), mSampleRate, 0, mIDCounts ) )
+                return false;
+
+            const U8* spooled = spool.GetData();
+            LINFrameTableRecord record;
+            for( U64 offset = 0; offset + SpoolRecordSize <= spool.GetSize(); offset += SpoolRecordSize )
+            {
+                memcpy( &record.mTimestamp, &spooled[ offset ], 8 );
+                record.mIdentifier = spooled[ offset + 8 ];
+                record.mLength = spooled[ offset + 9 ];
+                memcpy( record.mData, &spooled[ offset + 10 ], 8 );
+                record.mChecksum = spooled[ offset + 18 ];
+                record.mFlags = spooled[ offset + 19 ];
+                writer.Add( record );
+            }
+            return writer.Close();
+        }
+
+        std::string mPath;
+        std::string mSpoolPath;
+        std::ofstream mSpool;
+        BlockBuffer mBuffer;
+        U64 mSampleRate;
+        U64 mIDCounts[ LINFrameTableIndexEntries ];
+    };
+
+    // writes out each LIN frame the decoder reports, turned into a record by LINFrameTableWriter::MakeRecord() just as the
+    // analyzer's binary export does, so the two agree on where a frame ends and which byte is its checksum.
+    class RecordCollector : public LINDecoderSink
+    {
+      public:
+        RecordCollector( RecordOutput* output ) : mOutput( output ), mFrames( 0 ), mErrorFrames( 0 )
+        {
+        }
+
+        virtual void OnMarker( U64 /*sample*/, LINDecoder::tLINMarker /*marker*/ )
+        {
+        }
+
+        virtual void OnInterByteSpace( S64 /*starting_sample*/, S64 /*ending_sample*/ )
+        {
+        }
+
+        virtual void OnField( const LINDecoder::Field& /*field*/ )
+        {
+        }
+
+        virtual void OnLINFrame( const LINDecoder::LINFrame& lin_frame )
+        {
+            LINFrameTableRecord record;
+            LINFrameTableWriter::MakeRecord( lin_frame, record );
+            mOutput->Add( record );
+            ++mFrames;
+            if( ( record.mFlags & ~LINFrameTableNoChecksum ) != 0 )
+                ++mErrorFrames;
+        }
+
+        U64 GetFrames() const
+        {
+            return mFrames;
+        }
+
+        U64 GetErrorFrames() const
+        {
+            return mErrorFrames;
+        }
+
+      private:
+        RecordOutput* mOutput;
+        U64 mFrames;
+        U64 mErrorFrames;
+    };
+
+    int Usage( const char* program )
+    {
+        fprintf( stderr,
+                 "usage: %s [--format timestamps|bits] [--sample-rate HZ] [--bit-rate BPS] [--lin-version V] [--ldf PATH]\n"
+                 "          [--output csv|table] CAPTURE OUTPUT\n"
+                 "       %s --verify [--lin-version V] [--ldf PATH] TABLE\n"
+                 "  timestamps: a Logic 2 binary export of one digital channel (default)\n"
+                 "  bits:       one bit per sample, least significant bit first; needs --sample-rate\n"
+                 "  --verify:   checks the checksums recorded in a frame table; exits with 3 if any are wrong\n",
+                 program, program );
+        return 2;
+    }
+
+    // the checksum model of each ID comes from the decoder, so the LIN version and LDF mean the same as when decoding.
+    int VerifyTable( const char* path, const LINDecoder::Settings& settings )
+    {
+        LINFrameTableReader table;
+        if( !table.Open( path ) )
+        {
+            fprintf( stderr, "%s isn't a LIN frame table\n", path );
+            return 1;
+        }
+
+        LINDecoder decoder;
+        decoder.Configure( settings );
+        bool enhanced_ids[ 64 ];
+        for( U32 identifier = 0; identifier < 64; identifier++ )
+            enhanced_ids[ identifier ] = decoder.UsesEnhancedChecksum( U8( identifier ) );
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        U64 checked;
+        const U64 mismatches = table.VerifyChecksums( enhanced_ids, checked );
+        const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+
+        fprintf( stderr, "%llu of %llu frames checked, %llu checksums wrong, in %.3f s\n", checked, table.GetRecordCount(), mismatches,
+                 seconds );
+        return mismatches == 0 ? 0 : 3;
+    }
+}
+
+int main( int argc, char** argv )
+{
+    bool sample_bits = false;
+    bool table = false;
+    bool verify = false;
+    U64 sample_rate = 0;
+    LINDecoder::Settings settings;
+    const char* capture_path = NULL;
+    const char* output_path = NULL;
+    for( int i = 1; i < argc; i++ )
+    {
+        if( strcmp( argv[ i ], "--format" ) == 0 && i + 1 < argc )
+        {
+            ++i;
+            if( strcmp( argv[ i ], "bits" ) == 0 )
+                sample_bits = true;
+            else if( strcmp( argv[ i ], "timestamps" ) != 0 )
+                return Usage( argv[ 0 ] );
+        }
+        else if( strcmp( argv[ i ], "--output" ) == 0 && i + 1 < argc )
+        {
+            ++i;
+            if( strcmp( argv[ i ], "table" ) == 0 )
+                table = true;
+            else if( strcmp( argv[ i ], "csv" ) != 0 )
+                return Usage( argv[ 0 ] );
+        }
+        else if( strcmp( argv[ i ], "--verify" ) == 0 )
+            verify = true;
+        else if( strcmp( argv[ i ], "--sample-rate" ) == 0 && i + 1 < argc )
+            sample_rate = strtoull( argv[ ++i ], NULL, 10 );
+        else if( strcmp( argv[ i ], "--bit-rate" ) == 0 && i + 1 < argc )
+            settings.mBitRate = U32( strtoul( argv[ ++i ], NULL, 10 ) );
+        else if( strcmp( argv[ i ], "--lin-version" ) == 0 && i + 1 < argc )
+            settings.mLINVersion = strtod( argv[ ++i ], NULL );
+        else if( strcmp( argv[ i ], "--ldf" ) == 0 && i + 1 < argc )
+            settings.mDescriptionFile = argv[ ++i ];
+        else if( argv[ i ][ 0 ] != '-' && capture_path == NULL )
+            capture_path = argv[ i ];
+        else if( argv[ i ][ 0 ] != '-' && output_path == NULL )
+            output_path = argv[ i ];
+        else
+            return Usage( argv[ 0 ] );
+    }
+    if( verify )
+        return capture_path != NULL && output_path == NULL ? VerifyTable( capture_path, settings ) : Usage( argv[ 0 ] );
+    if( capture_path == NULL || output_path == NULL )
+        return Usage( argv[ 0 ] );
+
+    if( sample_rate == 0 && !sample_bits )
+        sample_rate = DefaultTimestampSampleRate;
+    if( sample_rate == 0 || sample_rate > 0xFFFFFFFFull || settings.mBitRate == 0 || settings.mBitRate * 4ull > sample_rate )
+    {
+        fprintf( stderr, "the sample rate must be at least 4 times the bit rate%s\n", sample_bits ? ", and is needed for bits" : "" );
+        return 2;
+    }
+    settings.mSampleRate = U32( sample_rate );
+
+    LINMappedFile capture;
+    if( !capture.Open( capture_path ) )
+    {
+        fprintf( stderr, "can't read %s\n", capture_path );
+        return 1;
+    }
+
+    LINTransitionTimes transition_times;
+    LINSampleBits sample_bit_source( capture.GetData(), capture.GetSize() );
+    LINEdgeSource* source = &sample_bit_source;
+    if( !sample_bits )
+    {
+        if( !transition_times.Open( capture.GetData(), capture.GetSize(), sample_rate ) )
+        {
+            fprintf( stderr, "%s isn't a Logic 2 binary export of a digital channel\n", capture_path );
+            return 1;
+        }
+        source = &transition_times;
+    }
+
+    CsvOutput csv( sample_rate );
+    TableOutput frame_table( sample_rate );
+    RecordOutput* output = &csv;
+    bool opened = table ? frame_table.Open( output_path ) : csv.Open( output_path );
+    if( table )
+        output = &frame_table;
+    if( !opened )
+    {
+        fprintf( stderr, "can't write %s\n", output_path );
+        return 1;
+    }
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    RecordCollector collector( output );
+    LINDecoder decoder;
+    decoder.Run( source, &collector, settings );
+    if( !output->Close() )
+    {
+        fprintf( stderr, "can't write %s\n", output_path );
+        return 1;
+    }
+    const double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+
+    fprintf( stderr, "%llu LIN frames, %llu with errors; %.1f MB of capture in %.3f s (%.1f MB/s)\n", collector.GetFrames(),
+             collector.GetErrorFrames(), capture.GetSize() / 1e6, seconds, seconds > 0.0 ? capture.GetSize() / 1e6 / seconds : 0.0 );
+    return 0;
+}